@@ -0,0 +1,575 @@
+/********************************************************
+ * Description : cm256 codec benchmark
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <map>
+#include <string>
+#include "gf256.h"
+#include "gf65536.h"
+#include "cm256.h"
+#include "cm65536.h"
+#include "cm256_fixed.h"
+#include "cm256_codec.h"
+#include "cm256_wide.h"
+#include "cm256_crc32c.h"
+
+/*
+ * usage: cm256_codec_bench [quick] [output.json]
+ *        cm256_codec_bench compare base.json other.json
+ *        cm256_codec_bench check
+ * every case is run until it has taken min_seconds, results are written as one json document
+ * (stdout by default) with ns/op, MB/s of block payload and ops/s, so runs can be diffed across releases,
+ * compare prints the speedup of every case both documents hold and their geometric mean,
+ * check only verifies CM256Fixed against CM256 and times nothing, ctest runs it,
+ * the kernel and core cases use the internal gf/cm classes, so link it against the static library
+ */
+
+struct bench_result_t
+{
+    std::string                         group;
+    std::string                         name;
+    std::string                         params;
+    double                              ns_per_op;
+    double                              mb_per_s;
+    double                              ops_per_s;
+};
+
+static double s_min_seconds = 0.2;
+static bool s_check_only = false;
+static std::list<bench_result_t> s_result_list;
+
+static uint32_t s_random = 0x12345678;
+
+static uint32_t get_random()
+{
+    s_random ^= s_random << 13;
+    s_random ^= s_random >> 17;
+    s_random ^= s_random << 5;
+    return s_random;
+}
+
+static void fill_random(std::vector<uint8_t> & buffer)
+{
+    for (std::size_t index = 0; index < buffer.size(); ++index)
+    {
+        buffer[index] = static_cast<uint8_t>(get_random());
+    }
+}
+
+template <typename Op>
+static double run_case(Op op)
+{
+    typedef std::chrono::steady_clock clock_t;
+
+    op();
+
+    uint64_t count = 0;
+    uint64_t batch = 1;
+    const clock_t::time_point begin = clock_t::now();
+    double seconds = 0.0;
+    do
+    {
+        for (uint64_t index = 0; index < batch; ++index)
+        {
+            op();
+        }
+        count += batch;
+        batch *= 2;
+        seconds = std::chrono::duration<double>(clock_t::now() - begin).count();
+    } while (seconds < s_min_seconds);
+
+    return seconds * 1e9 / static_cast<double>(count);
+}
+
+/* bytes_per_op is the payload each op processes, ops_per_op the items (packets, blocks) it handles */
+template <typename Op>
+static void add_case(const char * group, const char * name, const std::string & params, double bytes_per_op, double ops_per_op, Op op)
+{
+    bench_result_t result;
+    result.group = group;
+    result.name = name;
+    result.params = params;
+    result.ns_per_op = run_case(op);
+    result.mb_per_s = bytes_per_op * 1e3 / result.ns_per_op;
+    result.ops_per_s = ops_per_op * 1e9 / result.ns_per_op;
+    s_result_list.push_back(result);
+
+    fprintf(stderr, "%-8s %-24s %-28s %14.1f ns/op %10.1f MB/s\n", group, name, params.c_str(), result.ns_per_op, result.mb_per_s);
+}
+
+static std::string format_params(const char * format, int a, int b = 0, int c = 0)
+{
+    char buffer[128] = { 0x0 };
+    snprintf(buffer, sizeof(buffer), format, a, b, c);
+    return buffer;
+}
+
+static void bench_gf_kernels()
+{
+    static gf256_ctx s_gf256;
+    static gf65536_ctx s_gf65536;
+
+    const int block_bytes_list[] = { 64, 256, 1024, 1400, 4096, 65536 };
+    for (std::size_t index = 0; index < sizeof(block_bytes_list) / sizeof(block_bytes_list[0]); ++index)
+    {
+        const int bytes = block_bytes_list[index];
+        const std::string params = format_params("{\"bytes\":%d}", bytes);
+
+        std::vector<uint8_t> x(bytes), y(bytes), z(bytes);
+        fill_random(x);
+        fill_random(y);
+        fill_random(z);
+
+        add_case("gf256", "add_mem", params, bytes, 1, [&]() { gf256_ctx::gf256_add_mem(&z[0], &x[0], bytes); });
+        add_case("gf256", "add2_mem", params, bytes, 1, [&]() { gf256_ctx::gf256_add2_mem(&z[0], &x[0], &y[0], bytes); });
+        add_case("gf256", "addset_mem", params, bytes, 1, [&]() { gf256_ctx::gf256_addset_mem(&z[0], &x[0], &y[0], bytes); });
+        add_case("gf256", "mul_mem", params, bytes, 1, [&]() { s_gf256.gf256_mul_mem(&z[0], &x[0], 0x8e, bytes); });
+        add_case("gf256", "muladd_mem", params, bytes, 1, [&]() { s_gf256.gf256_muladd_mem(&z[0], 0x8e, &x[0], bytes); });
+        add_case("gf256", "div_mem", params, bytes, 1, [&]() { s_gf256.gf256_div_mem(&z[0], &x[0], 0x8e, bytes); });
+        add_case("gf65536", "mul_mem", params, bytes, 1, [&]() { s_gf65536.gf65536_mul_mem(&z[0], &x[0], 0x8e3b, bytes); });
+        add_case("gf65536", "muladd_mem", params, bytes, 1, [&]() { s_gf65536.gf65536_muladd_mem(&z[0], 0x8e3b, &x[0], bytes); });
+        add_case("crc32c", "checksum", params, bytes, 1, [&]() { z[0] = static_cast<uint8_t>(cm256_crc32c(&x[0], bytes, z[0])); });
+    }
+}
+
+static void bench_cm256_core()
+{
+    static CM256 s_cm256;
+
+    const int bytes = 1400;
+    const int grid[][2] = { { 16, 4 }, { 32, 8 }, { 64, 16 }, { 128, 32 }, { 200, 55 } };
+    for (std::size_t index = 0; index < sizeof(grid) / sizeof(grid[0]); ++index)
+    {
+        const int k = grid[index][0];
+        const int m = grid[index][1];
+
+        std::vector<std::vector<uint8_t>> original_data(k, std::vector<uint8_t>(bytes));
+        std::vector<std::vector<uint8_t>> recovery_data(m, std::vector<uint8_t>(bytes));
+        std::vector<CM256::cm256_block> originals(k);
+        std::vector<uint8_t *> recovery_blocks(m);
+        for (int i = 0; i < k; ++i)
+        {
+            fill_random(original_data[i]);
+            originals[i].Block = &original_data[i][0];
+            originals[i].Index = static_cast<unsigned char>(i);
+        }
+        for (int i = 0; i < m; ++i)
+        {
+            recovery_blocks[i] = &recovery_data[i][0];
+        }
+
+        CM256::cm256_encoder_params params = { k, m, bytes };
+        add_case("cm256", "encode", format_params("{\"k\":%d,\"m\":%d,\"bytes\":%d}", k, m, bytes), static_cast<double>(k) * bytes, 1, [&]() { s_cm256.cm256_encode(params, &originals[0], &recovery_blocks[0]); });
+
+        /* same blocks, but four in five only hold 64..319 bytes before their zero padding */
+        std::vector<int> original_bytes(k);
+        for (int i = 0; i < k; ++i)
+        {
+            original_bytes[i] = (0 == i % 5 ? bytes : 64 + static_cast<int>(get_random() % 256));
+        }
+        add_case("cm256", "encode_skewed", format_params("{\"k\":%d,\"m\":%d,\"bytes\":%d}", k, m, bytes), static_cast<double>(k) * bytes, 1, [&]() { s_cm256.cm256_encode(params, &originals[0], &recovery_blocks[0], &original_bytes[0]); });
+
+        const int loss_list[] = { 1, (m + 1) / 2, m };
+        for (std::size_t loss_index = 0; loss_index < sizeof(loss_list) / sizeof(loss_list[0]); ++loss_index)
+        {
+            const int loss = loss_list[loss_index];
+
+            /* the first 'loss' originals are replaced by recovery blocks, restored before every decode */
+            std::vector<std::vector<uint8_t>> work_data(recovery_data.begin(), recovery_data.begin() + loss);
+            std::vector<CM256::cm256_block> blocks(originals);
+            add_case("cm256", "decode", format_params("{\"k\":%d,\"m\":%d,\"loss\":%d}", k, m, loss), static_cast<double>(k) * bytes, 1, [&]()
+            {
+                for (int i = 0; i < loss; ++i)
+                {
+                    memcpy(&work_data[i][0], &recovery_data[i][0], bytes);
+                    blocks[i].Block = &work_data[i][0];
+                    blocks[i].Index = static_cast<unsigned char>(k + i);
+                }
+                s_cm256.cm256_decode(params, &blocks[0]);
+            });
+        }
+    }
+}
+
+/* the same shape through CM256::cm256_encode() and CM256Fixed, side by side, once their outputs agree */
+template <int K, int M, int BlockBytes>
+static bool bench_cm256_fixed_shape()
+{
+    static CM256 s_cm256;
+    static CM256Fixed<K, M, BlockBytes> s_fixed;
+
+    std::vector<std::vector<uint8_t>> original_data(K, std::vector<uint8_t>(BlockBytes));
+    std::vector<std::vector<uint8_t>> recovery_data(M, std::vector<uint8_t>(BlockBytes));
+    std::vector<CM256::cm256_block> originals(K);
+    std::vector<uint8_t *> recovery_blocks(M);
+    for (int i = 0; i < K; ++i)
+    {
+        fill_random(original_data[i]);
+        originals[i].Block = &original_data[i][0];
+        originals[i].Index = static_cast<unsigned char>(i);
+    }
+    for (int i = 0; i < M; ++i)
+    {
+        recovery_blocks[i] = &recovery_data[i][0];
+    }
+
+    const std::string params = format_params("{\"k\":%d,\"m\":%d,\"bytes\":%d}", K, M, BlockBytes);
+    CM256::cm256_encoder_params encoder_params = { K, M, BlockBytes };
+
+    std::vector<std::vector<uint8_t>> fixed_data(M, std::vector<uint8_t>(BlockBytes));
+    std::vector<uint8_t *> fixed_blocks(M);
+    for (int i = 0; i < M; ++i)
+    {
+        fixed_blocks[i] = &fixed_data[i][0];
+    }
+    if (0 != s_cm256.cm256_encode(encoder_params, &originals[0], &recovery_blocks[0]) || 0 != s_fixed.cm256_encode(&originals[0], &fixed_blocks[0]) || recovery_data != fixed_data)
+    {
+        fprintf(stderr, "fixed_encode %s differs from cm256_encode\n", params.c_str());
+        return false;
+    }
+
+    /* the first M originals are replaced by the fixed encoder's recovery blocks */
+    std::vector<CM256::cm256_block> blocks(originals);
+    for (int i = 0; i < M && i < K; ++i)
+    {
+        blocks[i].Block = fixed_blocks[i];
+        blocks[i].Index = static_cast<unsigned char>(K + i);
+    }
+    if (0 != s_fixed.cm256_decode(&blocks[0]))
+    {
+        fprintf(stderr, "fixed_decode %s failed\n", params.c_str());
+        return false;
+    }
+    for (int i = 0; i < M && i < K; ++i)
+    {
+        if (blocks[i].Index >= K || 0 != memcmp(blocks[i].Block, &original_data[blocks[i].Index][0], BlockBytes))
+        {
+            fprintf(stderr, "fixed_decode %s recovered the wrong data\n", params.c_str());
+            return false;
+        }
+    }
+
+    if (s_check_only)
+    {
+        return true;
+    }
+
+    add_case("fixed", "generic_encode", params, static_cast<double>(K) * BlockBytes, 1, [&]() { s_cm256.cm256_encode(encoder_params, &originals[0], &recovery_blocks[0]); });
+    add_case("fixed", "fixed_encode", params, static_cast<double>(K) * BlockBytes, 1, [&]() { s_fixed.cm256_encode(&originals[0], &recovery_blocks[0]); });
+    return true;
+}
+
+/* 100 bytes leave a tail after the 16 byte steps, one original makes the recovery blocks copies */
+static bool bench_cm256_fixed()
+{
+    return bench_cm256_fixed_shape<20, 4, 1200>() && bench_cm256_fixed_shape<16, 4, 1400>() && bench_cm256_fixed_shape<10, 2, 1400>() &&
+        bench_cm256_fixed_shape<32, 8, 1400>() && bench_cm256_fixed_shape<5, 3, 100>() && bench_cm256_fixed_shape<1, 2, 64>();
+}
+
+static void bench_cm65536_core()
+{
+    static CM65536 s_cm65536;
+
+    const int bytes = 1400;
+    const int grid[][2] = { { 200, 56 }, { 400, 100 }, { 800, 200 } };
+    for (std::size_t index = 0; index < sizeof(grid) / sizeof(grid[0]); ++index)
+    {
+        const int k = grid[index][0];
+        const int m = grid[index][1];
+
+        std::vector<std::vector<uint8_t>> original_data(k, std::vector<uint8_t>(bytes));
+        std::vector<std::vector<uint8_t>> recovery_data(m, std::vector<uint8_t>(bytes));
+        std::vector<CM65536::cm65536_block> originals(k);
+        std::vector<uint8_t *> recovery_blocks(m);
+        for (int i = 0; i < k; ++i)
+        {
+            fill_random(original_data[i]);
+            originals[i].Block = &original_data[i][0];
+            originals[i].Index = static_cast<uint16_t>(i);
+        }
+        for (int i = 0; i < m; ++i)
+        {
+            recovery_blocks[i] = &recovery_data[i][0];
+        }
+
+        CM65536::cm65536_encoder_params params = { k, m, bytes };
+        add_case("cm65536", "encode", format_params("{\"k\":%d,\"m\":%d,\"bytes\":%d}", k, m, bytes), static_cast<double>(k) * bytes, 1, [&]() { s_cm65536.cm65536_encode(params, &originals[0], &recovery_blocks[0]); });
+
+        const int loss = m;
+        std::vector<std::vector<uint8_t>> work_data(recovery_data.begin(), recovery_data.begin() + loss);
+        std::vector<CM65536::cm65536_block> blocks(originals);
+        add_case("cm65536", "decode", format_params("{\"k\":%d,\"m\":%d,\"loss\":%d}", k, m, loss), static_cast<double>(k) * bytes, 1, [&]()
+        {
+            for (int i = 0; i < loss; ++i)
+            {
+                memcpy(&work_data[i][0], &recovery_data[i][0], bytes);
+                blocks[i].Block = &work_data[i][0];
+                blocks[i].Index = static_cast<uint16_t>(k + i);
+            }
+            s_cm65536.cm65536_decode(params, &blocks[0]);
+        });
+    }
+}
+
+static void bench_codec()
+{
+    const int packet_count = 1000;
+    const int packet_bytes = 1200;
+
+    std::list<std::vector<uint8_t>> src_data_list;
+    for (int i = 0; i < packet_count; ++i)
+    {
+        std::vector<uint8_t> data(packet_bytes);
+        fill_random(data);
+        src_data_list.push_back(data);
+    }
+
+    const double rate_list[] = { 0.1, 0.3 };
+    for (std::size_t index = 0; index < sizeof(rate_list) / sizeof(rate_list[0]); ++index)
+    {
+        const double recovery_rate = rate_list[index];
+        const int rate_percent = static_cast<int>(recovery_rate * 100 + 0.5);
+
+        std::list<std::vector<uint8_t>> tmp_data_list;
+        add_case("codec", "encode", format_params("{\"packets\":%d,\"bytes\":%d,\"rate\":%d}", packet_count, packet_bytes, rate_percent), static_cast<double>(packet_count) * packet_bytes, packet_count, [&]()
+        {
+            uint16_t frame_index = 0;
+            uint8_t frame_filter = 0;
+            tmp_data_list.clear();
+            cm256_encode(frame_index, frame_filter, tmp_data_list, src_data_list, recovery_rate);
+        });
+
+        /* drop every 20th block so that most frames go through the decoder */
+        std::list<std::vector<uint8_t>> recv_data_list;
+        std::size_t block_index = 0;
+        for (std::list<std::vector<uint8_t>>::const_iterator iter = tmp_data_list.begin(); tmp_data_list.end() != iter; ++iter, ++block_index)
+        {
+            if (0 != block_index % 20)
+            {
+                recv_data_list.push_back(*iter);
+            }
+        }
+
+        add_case("codec", "decode", format_params("{\"packets\":%d,\"bytes\":%d,\"rate\":%d}", packet_count, packet_bytes, rate_percent), static_cast<double>(packet_count) * packet_bytes, packet_count, [&]()
+        {
+            frames_t frames;
+            std::list<std::vector<uint8_t>> dst_data_list;
+            for (std::list<std::vector<uint8_t>>::const_iterator iter = recv_data_list.begin(); recv_data_list.end() != iter; ++iter)
+            {
+                cm256_decode(&(*iter)[0], iter->size(), frames, dst_data_list, 1000 * 15, false);
+            }
+        });
+
+        add_case("codec", "wide_encode", format_params("{\"packets\":%d,\"bytes\":%d,\"rate\":%d}", packet_count, packet_bytes, rate_percent), static_cast<double>(packet_count) * packet_bytes, packet_count, [&]()
+        {
+            uint16_t frame_index = 0;
+            uint8_t frame_filter = 0;
+            tmp_data_list.clear();
+            cm256_wide_encode(frame_index, frame_filter, tmp_data_list, src_data_list, recovery_rate, 0, false, 500);
+        });
+    }
+}
+
+/* mostly small packets with a few near the mtu, every block is padded to the largest */
+static void bench_codec_skewed()
+{
+    const int packet_count = 1000;
+
+    std::list<std::vector<uint8_t>> src_data_list;
+    double payload_bytes = 0;
+    for (int i = 0; i < packet_count; ++i)
+    {
+        std::vector<uint8_t> data(0 == i % 10 ? 1200 + get_random() % 200 : 64 + get_random() % 192);
+        fill_random(data);
+        payload_bytes += static_cast<double>(data.size());
+        src_data_list.push_back(data);
+    }
+
+    const double recovery_rate = 0.3;
+
+    std::list<std::vector<uint8_t>> tmp_data_list;
+    add_case("codec", "encode_skewed", format_params("{\"packets\":%d,\"small\":%d,\"rate\":%d}", packet_count, 90, 30), payload_bytes, packet_count, [&]()
+    {
+        uint16_t frame_index = 0;
+        uint8_t frame_filter = 0;
+        tmp_data_list.clear();
+        cm256_encode(frame_index, frame_filter, tmp_data_list, src_data_list, recovery_rate);
+    });
+
+    std::list<std::vector<uint8_t>> recv_data_list;
+    std::size_t block_index = 0;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = tmp_data_list.begin(); tmp_data_list.end() != iter; ++iter, ++block_index)
+    {
+        if (0 != block_index % 20)
+        {
+            recv_data_list.push_back(*iter);
+        }
+    }
+
+    add_case("codec", "decode_skewed", format_params("{\"packets\":%d,\"small\":%d,\"rate\":%d}", packet_count, 90, 30), payload_bytes, packet_count, [&]()
+    {
+        frames_t frames;
+        std::list<std::vector<uint8_t>> dst_data_list;
+        for (std::list<std::vector<uint8_t>>::const_iterator iter = recv_data_list.begin(); recv_data_list.end() != iter; ++iter)
+        {
+            cm256_decode(&(*iter)[0], iter->size(), frames, dst_data_list, 1000 * 15, false);
+        }
+    });
+}
+
+static void write_json(FILE * file)
+{
+    fprintf(file, "{\n  \"min_seconds\": %g,\n  \"results\": [\n", s_min_seconds);
+    for (std::list<bench_result_t>::const_iterator iter = s_result_list.begin(); s_result_list.end() != iter; ++iter)
+    {
+        fprintf(file, "    {\"group\":\"%s\",\"name\":\"%s\",\"params\":%s,\"ns_per_op\":%.1f,\"mb_per_s\":%.2f,\"ops_per_s\":%.1f}%s\n", 
+            iter->group.c_str(), iter->name.c_str(), iter->params.c_str(), iter->ns_per_op, iter->mb_per_s, iter->ops_per_s, 
+            (std::next(iter) == s_result_list.end() ? "" : ","));
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+/* the text between begin and the next quote, or up to the closing brace for the params object */
+static std::string get_json_field(const char * line, const char * begin, char end)
+{
+    const char * field = strstr(line, begin);
+    if (nullptr == field)
+    {
+        return std::string();
+    }
+    field += strlen(begin);
+    const char * field_end = strchr(field, end);
+    return (nullptr == field_end ? std::string() : std::string(field, field_end + ('}' == end ? 1 : 0)));
+}
+
+/* reads back the result lines write_json produced, in their order */
+static bool read_json(const char * path, std::list<std::pair<std::string, double>> & result_list)
+{
+    FILE * file = fopen(path, "r");
+    if (nullptr == file)
+    {
+        fprintf(stderr, "cannot open %s\n", path);
+        return false;
+    }
+
+    char line[1024] = { 0x0 };
+    while (nullptr != fgets(line, sizeof(line), file))
+    {
+        const std::string group = get_json_field(line, "\"group\":\"", '"');
+        const std::string ns_per_op = get_json_field(line, "\"ns_per_op\":", ',');
+        if (group.empty() || ns_per_op.empty())
+        {
+            continue;
+        }
+        const std::string key = group + " " + get_json_field(line, "\"name\":\"", '"') + " " + get_json_field(line, "\"params\":", '}');
+        result_list.push_back(std::make_pair(key, atof(ns_per_op.c_str())));
+    }
+
+    fclose(file);
+    return true;
+}
+
+static int compare_json(const char * base_path, const char * other_path)
+{
+    std::list<std::pair<std::string, double>> base_list;
+    std::list<std::pair<std::string, double>> other_list;
+    if (!read_json(base_path, base_list) || !read_json(other_path, other_list))
+    {
+        return 1;
+    }
+
+    std::map<std::string, double> other_map(other_list.begin(), other_list.end());
+
+    double log_sum = 0.0;
+    std::size_t count = 0;
+    printf("%-64s %14s %14s %9s\n", "case", "base ns/op", "ns/op", "speedup");
+    for (std::list<std::pair<std::string, double>>::const_iterator iter = base_list.begin(); base_list.end() != iter; ++iter)
+    {
+        std::map<std::string, double>::const_iterator other = other_map.find(iter->first);
+        if (other_map.end() == other || iter->second <= 0.0 || other->second <= 0.0)
+        {
+            continue;
+        }
+        const double speedup = iter->second / other->second;
+        printf("%-64s %14.1f %14.1f %8.3fx\n", iter->first.c_str(), iter->second, other->second, speedup);
+        log_sum += log(speedup);
+        ++count;
+    }
+
+    if (0 == count)
+    {
+        fprintf(stderr, "no case in common\n");
+        return 1;
+    }
+
+    printf("geometric mean speedup over %zu cases: %.3fx\n", count, exp(log_sum / static_cast<double>(count)));
+    return 0;
+}
+
+int main(int argc, char * argv[])
+{
+    if (argc >= 2 && 0 == strcmp(argv[1], "compare"))
+    {
+        if (4 != argc)
+        {
+            fprintf(stderr, "usage: %s compare base.json other.json\n", argv[0]);
+            return 1;
+        }
+        return compare_json(argv[2], argv[3]);
+    }
+
+    const char * output_path = nullptr;
+    for (int index = 1; index < argc; ++index)
+    {
+        if (0 == strcmp(argv[index], "quick"))
+        {
+            s_min_seconds = 0.02;
+        }
+        else if (0 == strcmp(argv[index], "check"))
+        {
+            s_check_only = true;
+        }
+        else
+        {
+            output_path = argv[index];
+        }
+    }
+
+    if (s_check_only)
+    {
+        return bench_cm256_fixed() ? 0 : 1;
+    }
+
+    bench_gf_kernels();
+    bench_cm256_core();
+    if (!bench_cm256_fixed())
+    {
+        return 1;
+    }
+    bench_cm65536_core();
+    bench_codec();
+    bench_codec_skewed();
+
+    FILE * file = (nullptr != output_path ? fopen(output_path, "w") : stdout);
+    if (nullptr == file)
+    {
+        return 1;
+    }
+    write_json(file);
+    if (stdout != file)
+    {
+        fclose(file);
+    }
+
+    return 0;
+}
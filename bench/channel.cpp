@@ -0,0 +1,437 @@
+/********************************************************
+ * Description : cm256 codec loss channel simulator
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <string>
+#include <algorithm>
+#include "cm256_codec.h"
+
+/*
+ * usage: cm256_codec_channel [key=value ...]
+ * packets are produced every interval_us, encoded with cm256_encode() (encoder=batch, every batch packets)
+ * or cm256_stream_encode() (encoder=stream), sent through a seeded loss channel and fed to cm256_decode(),
+ * the codec runs on a virtual clock so the same arguments always give the same report (cpu time aside),
+ * min_bytes=N draws every payload size from [N, bytes] instead of always sending bytes
+ *
+ * channel: model=bernoulli loss=P | model=gilbert p_gb=P p_bg=P loss_good=P loss_bad=P,
+ *          latency_us=T jitter_us=T (uniform), reorder=P reorder_us=T (extra delay), duplicate=P
+ */
+
+struct channel_config_t
+{
+    uint64_t                            seed;
+    std::size_t                         packets;
+    std::size_t                         bytes;
+    std::size_t                         min_bytes;
+    uint32_t                            interval_us;
+    std::string                         encoder;
+    std::size_t                         batch;
+    double                              recovery_rate;
+    std::size_t                         max_original_count;
+    uint32_t                            encode_delay_us;
+    uint32_t                            decode_delay_us;
+    uint32_t                            poll_us;
+    std::string                         model;
+    double                              loss;
+    double                              p_gb;
+    double                              p_bg;
+    double                              loss_good;
+    double                              loss_bad;
+    uint32_t                            latency_us;
+    uint32_t                            jitter_us;
+    double                              reorder;
+    uint32_t                            reorder_us;
+    double                              duplicate;
+
+    channel_config_t();
+};
+
+channel_config_t::channel_config_t()
+    : seed(1)
+    , packets(20000)
+    , bytes(1200)
+    , min_bytes(0)
+    , interval_us(100)
+    , encoder("stream")
+    , batch(100)
+    , recovery_rate(0.1)
+    , max_original_count(0)
+    , encode_delay_us(1000 * 15)
+    , decode_delay_us(1000 * 15)
+    , poll_us(1000)
+    , model("bernoulli")
+    , loss(0.05)
+    , p_gb(0.01)
+    , p_bg(0.25)
+    , loss_good(0.0)
+    , loss_bad(0.5)
+    , latency_us(1000 * 20)
+    , jitter_us(0)
+    , reorder(0.0)
+    , reorder_us(1000 * 5)
+    , duplicate(0.0)
+{
+}
+
+static uint64_t s_now_us = 0;
+
+static void CM256_CODEC_CDECL get_virtual_time(uint32_t & seconds, uint32_t & microseconds)
+{
+    /* an arbitrary epoch far from zero, deadlines are computed as seconds + microseconds */
+    seconds = static_cast<uint32_t>(1000000 + s_now_us / 1000000);
+    microseconds = static_cast<uint32_t>(s_now_us % 1000000);
+}
+
+class channel_t
+{
+public:
+    explicit channel_t(const channel_config_t & config)
+        : m_config(config)
+        , m_random(config.seed)
+        , m_bad_state(false)
+        , m_sent_blocks(0)
+        , m_lost_blocks(0)
+        , m_duplicated_blocks(0)
+        , m_sent_bytes(0)
+    {
+    }
+
+    void send(uint64_t now_us, const std::vector<uint8_t> & data, std::multimap<uint64_t, std::vector<uint8_t>> & arrival_map)
+    {
+        ++m_sent_blocks;
+        m_sent_bytes += data.size();
+
+        if (is_lost())
+        {
+            ++m_lost_blocks;
+            return;
+        }
+
+        arrival_map.insert(std::make_pair(now_us + get_delay(), data));
+
+        if (get_uniform() < m_config.duplicate)
+        {
+            ++m_duplicated_blocks;
+            arrival_map.insert(std::make_pair(now_us + get_delay(), data));
+        }
+    }
+
+    uint64_t get_max_delay() const
+    {
+        return static_cast<uint64_t>(m_config.latency_us) + m_config.jitter_us + m_config.reorder_us;
+    }
+
+    std::size_t sent_blocks() const { return m_sent_blocks; }
+    std::size_t lost_blocks() const { return m_lost_blocks; }
+    std::size_t duplicated_blocks() const { return m_duplicated_blocks; }
+    std::size_t sent_bytes() const { return m_sent_bytes; }
+
+private:
+    /* 53 random bits, so the sequence only depends on mt19937_64 which is fully specified */
+    double get_uniform()
+    {
+        return static_cast<double>(m_random() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    bool is_lost()
+    {
+        if ("gilbert" != m_config.model)
+        {
+            return get_uniform() < m_config.loss;
+        }
+
+        if (m_bad_state)
+        {
+            if (get_uniform() < m_config.p_bg)
+            {
+                m_bad_state = false;
+            }
+        }
+        else
+        {
+            if (get_uniform() < m_config.p_gb)
+            {
+                m_bad_state = true;
+            }
+        }
+        return get_uniform() < (m_bad_state ? m_config.loss_bad : m_config.loss_good);
+    }
+
+    uint64_t get_delay()
+    {
+        uint64_t delay = m_config.latency_us;
+        if (0 != m_config.jitter_us)
+        {
+            delay += static_cast<uint64_t>(get_uniform() * m_config.jitter_us);
+        }
+        if (get_uniform() < m_config.reorder)
+        {
+            delay += m_config.reorder_us;
+        }
+        return delay;
+    }
+
+private:
+    const channel_config_t            & m_config;
+    std::mt19937_64                     m_random;
+    bool                                m_bad_state;
+    std::size_t                         m_sent_blocks;
+    std::size_t                         m_lost_blocks;
+    std::size_t                         m_duplicated_blocks;
+    std::size_t                         m_sent_bytes;
+};
+
+static bool parse_config(int argc, char * argv[], channel_config_t & config)
+{
+    for (int index = 1; index < argc; ++index)
+    {
+        const char * equal = strchr(argv[index], '=');
+        if (nullptr == equal)
+        {
+            return false;
+        }
+        const std::string key(argv[index], static_cast<std::size_t>(equal - argv[index]));
+        const char * value = equal + 1;
+
+        if ("seed" == key) config.seed = strtoull(value, nullptr, 10);
+        else if ("packets" == key) config.packets = strtoul(value, nullptr, 10);
+        else if ("bytes" == key) config.bytes = strtoul(value, nullptr, 10);
+        else if ("min_bytes" == key) config.min_bytes = strtoul(value, nullptr, 10);
+        else if ("interval_us" == key) config.interval_us = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        else if ("encoder" == key) config.encoder = value;
+        else if ("batch" == key) config.batch = strtoul(value, nullptr, 10);
+        else if ("rate" == key) config.recovery_rate = atof(value);
+        else if ("max_original_count" == key) config.max_original_count = strtoul(value, nullptr, 10);
+        else if ("encode_delay_us" == key) config.encode_delay_us = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        else if ("decode_delay_us" == key) config.decode_delay_us = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        else if ("poll_us" == key) config.poll_us = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        else if ("model" == key) config.model = value;
+        else if ("loss" == key) config.loss = atof(value);
+        else if ("p_gb" == key) config.p_gb = atof(value);
+        else if ("p_bg" == key) config.p_bg = atof(value);
+        else if ("loss_good" == key) config.loss_good = atof(value);
+        else if ("loss_bad" == key) config.loss_bad = atof(value);
+        else if ("latency_us" == key) config.latency_us = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        else if ("jitter_us" == key) config.jitter_us = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        else if ("reorder" == key) config.reorder = atof(value);
+        else if ("reorder_us" == key) config.reorder_us = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        else if ("duplicate" == key) config.duplicate = atof(value);
+        else return false;
+    }
+
+    if (0 == config.min_bytes)
+    {
+        config.min_bytes = config.bytes;
+    }
+
+    return config.bytes >= sizeof(uint32_t) && config.bytes < 65536 && config.min_bytes >= sizeof(uint32_t) && config.min_bytes <= config.bytes && 0 != config.packets && 0 != config.batch && 0 != config.poll_us &&
+        ("stream" == config.encoder || "batch" == config.encoder) && ("bernoulli" == config.model || "gilbert" == config.model);
+}
+
+static uint64_t get_percentile(const std::vector<uint64_t> & sorted_list, double percentile)
+{
+    if (sorted_list.empty())
+    {
+        return 0;
+    }
+    const std::size_t rank = static_cast<std::size_t>(std::ceil(percentile * static_cast<double>(sorted_list.size())));
+    return sorted_list[std::min(rank > 0 ? rank - 1 : 0, sorted_list.size() - 1)];
+}
+
+int main(int argc, char * argv[])
+{
+    typedef std::chrono::steady_clock clock_t;
+
+    channel_config_t config;
+    if (!parse_config(argc, argv, config))
+    {
+        fprintf(stderr, "usage: %s [key=value ...], see channel.cpp for the keys\n", argv[0]);
+        return 1;
+    }
+
+    cm256_set_clock(&get_virtual_time);
+
+    channel_t channel(config);
+    std::mt19937_64 payload_random(config.seed ^ 0x9e3779b97f4a7c15ULL);
+
+    std::vector<uint64_t> produce_time(config.packets, 0);
+    std::vector<uint8_t> delivered(config.packets, 0);
+    std::vector<uint64_t> latency_list;
+    std::size_t duplicate_deliveries = 0;
+    std::size_t produced_bytes = 0;
+    std::size_t delivered_bytes = 0;
+    double encode_ns = 0.0;
+    double decode_ns = 0.0;
+
+    std::multimap<uint64_t, std::vector<uint8_t>> arrival_map;
+    std::list<std::vector<uint8_t>> batch_list;
+    stream_encoder_t encoder;
+    uint16_t frame_index = 0;
+    uint8_t frame_filter = 0;
+    frames_t frames;
+
+    std::size_t produced = 0;
+    uint64_t next_produce_us = 0;
+    uint64_t next_poll_us = config.poll_us;
+    uint64_t drain_end_us = 0;
+
+    while (produced < config.packets || !arrival_map.empty() || s_now_us < drain_end_us)
+    {
+        std::list<std::vector<uint8_t>> src_data_list;
+        std::list<std::vector<uint8_t>> dst_data_list;
+
+        uint64_t next_us = next_poll_us;
+        if (produced < config.packets)
+        {
+            next_us = std::min(next_us, next_produce_us);
+        }
+        if (!arrival_map.empty())
+        {
+            next_us = std::min(next_us, arrival_map.begin()->first);
+        }
+        s_now_us = next_us;
+
+        if (produced < config.packets && next_produce_us == s_now_us)
+        {
+            std::vector<uint8_t> data(config.min_bytes < config.bytes ? config.min_bytes + static_cast<std::size_t>(payload_random() % (config.bytes - config.min_bytes + 1)) : config.bytes);
+            produced_bytes += data.size();
+            for (std::size_t index = sizeof(uint32_t); index < data.size(); ++index)
+            {
+                data[index] = static_cast<uint8_t>(payload_random());
+            }
+            const uint32_t sequence = static_cast<uint32_t>(produced);
+            memcpy(&data[0], &sequence, sizeof(sequence));
+            produce_time[produced] = s_now_us;
+            ++produced;
+            next_produce_us += config.interval_us;
+
+            const clock_t::time_point begin = clock_t::now();
+            if ("stream" == config.encoder)
+            {
+                cm256_stream_encode(&data[0], data.size(), encoder, src_data_list, config.recovery_rate, config.bytes, config.max_original_count, config.encode_delay_us, true);
+                if (produced == config.packets)
+                {
+                    cm256_stream_flush(encoder, src_data_list);
+                }
+            }
+            else
+            {
+                batch_list.push_back(data);
+                if (batch_list.size() == config.batch || produced == config.packets)
+                {
+                    cm256_encode(frame_index, frame_filter, src_data_list, batch_list, config.recovery_rate, config.bytes, true, config.max_original_count);
+                    batch_list.clear();
+                }
+            }
+            encode_ns += std::chrono::duration<double, std::nano>(clock_t::now() - begin).count();
+
+            if (produced == config.packets)
+            {
+                /* the longest a frame can wait in the decoder, plus the slowest block */
+                drain_end_us = s_now_us + channel.get_max_delay() + static_cast<uint64_t>(config.decode_delay_us) * 256 + config.poll_us * 2;
+            }
+        }
+        else if (!arrival_map.empty() && arrival_map.begin()->first == s_now_us)
+        {
+            const std::vector<uint8_t> data(std::move(arrival_map.begin()->second));
+            arrival_map.erase(arrival_map.begin());
+
+            const clock_t::time_point begin = clock_t::now();
+            cm256_decode(&data[0], data.size(), frames, dst_data_list, config.decode_delay_us, false);
+            decode_ns += std::chrono::duration<double, std::nano>(clock_t::now() - begin).count();
+        }
+        else
+        {
+            next_poll_us += config.poll_us;
+
+            const clock_t::time_point begin = clock_t::now();
+            if ("stream" == config.encoder)
+            {
+                cm256_stream_encode(nullptr, 0, encoder, src_data_list, config.recovery_rate, config.bytes, config.max_original_count, config.encode_delay_us, true);
+            }
+            const clock_t::time_point middle = clock_t::now();
+            cm256_decode(nullptr, 0, frames, dst_data_list, config.decode_delay_us, false);
+            encode_ns += std::chrono::duration<double, std::nano>(middle - begin).count();
+            decode_ns += std::chrono::duration<double, std::nano>(clock_t::now() - middle).count();
+        }
+
+        for (std::list<std::vector<uint8_t>>::const_iterator iter = src_data_list.begin(); src_data_list.end() != iter; ++iter)
+        {
+            channel.send(s_now_us, *iter, arrival_map);
+        }
+
+        for (std::list<std::vector<uint8_t>>::const_iterator iter = dst_data_list.begin(); dst_data_list.end() != iter; ++iter)
+        {
+            uint32_t sequence = 0;
+            if (iter->size() < config.min_bytes || iter->size() > config.bytes || (memcpy(&sequence, &(*iter)[0], sizeof(sequence)), sequence >= config.packets))
+            {
+                continue;
+            }
+            if (delivered[sequence])
+            {
+                ++duplicate_deliveries;
+                continue;
+            }
+            delivered[sequence] = 1;
+            delivered_bytes += iter->size();
+            latency_list.push_back(s_now_us - produce_time[sequence]);
+        }
+    }
+
+    cm256_set_clock(nullptr);
+
+    std::sort(latency_list.begin(), latency_list.end());
+    double latency_mean = 0.0;
+    for (std::size_t index = 0; index < latency_list.size(); ++index)
+    {
+        latency_mean += static_cast<double>(latency_list[index]);
+    }
+    if (!latency_list.empty())
+    {
+        latency_mean /= static_cast<double>(latency_list.size());
+    }
+
+    const double byte_count = static_cast<double>(std::max<std::size_t>(delivered_bytes, 1));
+
+    printf("{\n");
+    printf("  \"config\": {\"seed\":%llu,\"packets\":%zu,\"bytes\":%zu,\"min_bytes\":%zu,\"interval_us\":%u,\"encoder\":\"%s\",\"batch\":%zu,\"rate\":%g,\"max_original_count\":%zu,"
+        "\"encode_delay_us\":%u,\"decode_delay_us\":%u,\"model\":\"%s\",\"loss\":%g,\"p_gb\":%g,\"p_bg\":%g,\"loss_good\":%g,\"loss_bad\":%g,"
+        "\"latency_us\":%u,\"jitter_us\":%u,\"reorder\":%g,\"reorder_us\":%u,\"duplicate\":%g},\n",
+        static_cast<unsigned long long>(config.seed), config.packets, config.bytes, config.min_bytes, config.interval_us, config.encoder.c_str(), config.batch, config.recovery_rate, config.max_original_count,
+        config.encode_delay_us, config.decode_delay_us, config.model.c_str(), config.loss, config.p_gb, config.p_bg, config.loss_good, config.loss_bad,
+        config.latency_us, config.jitter_us, config.reorder, config.reorder_us, config.duplicate);
+    printf("  \"channel\": {\"sent_blocks\":%zu,\"lost_blocks\":%zu,\"duplicated_blocks\":%zu,\"block_loss\":%.6f,\"overhead\":%.4f},\n",
+        channel.sent_blocks(), channel.lost_blocks(), channel.duplicated_blocks(),
+        static_cast<double>(channel.lost_blocks()) / static_cast<double>(std::max<std::size_t>(channel.sent_blocks(), 1)),
+        static_cast<double>(channel.sent_bytes()) / static_cast<double>(std::max<std::size_t>(produced_bytes, 1)));
+    printf("  \"delivery\": {\"packets\":%zu,\"delivered\":%zu,\"residual_loss\":%.6f,\"duplicate_deliveries\":%zu},\n",
+        config.packets, latency_list.size(), 1.0 - static_cast<double>(latency_list.size()) / static_cast<double>(config.packets), duplicate_deliveries);
+    printf("  \"latency_us\": {\"min\":%llu,\"mean\":%.1f,\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,\"p999\":%llu,\"max\":%llu},\n",
+        static_cast<unsigned long long>(get_percentile(latency_list, 0.0)), latency_mean,
+        static_cast<unsigned long long>(get_percentile(latency_list, 0.5)), static_cast<unsigned long long>(get_percentile(latency_list, 0.9)),
+        static_cast<unsigned long long>(get_percentile(latency_list, 0.99)), static_cast<unsigned long long>(get_percentile(latency_list, 0.999)),
+        static_cast<unsigned long long>(latency_list.empty() ? 0 : latency_list.back()));
+    decode_stats_t stats;
+    cm256_decode_stats(frames, stats);
+    printf("  \"decoder\": {\"blocks_duplicate\":%llu,\"blocks_late\":%llu,\"blocks_mismatch\":%llu,\"blocks_recovered\":%llu,"
+        "\"frames_complete\":%llu,\"frames_recovered\":%llu,\"frames_expired\":%llu,\"frames_failed\":%llu},\n",
+        static_cast<unsigned long long>(stats.blocks_duplicate), static_cast<unsigned long long>(stats.blocks_late),
+        static_cast<unsigned long long>(stats.blocks_mismatch), static_cast<unsigned long long>(stats.blocks_recovered),
+        static_cast<unsigned long long>(stats.frames_complete), static_cast<unsigned long long>(stats.frames_recovered),
+        static_cast<unsigned long long>(stats.frames_expired), static_cast<unsigned long long>(stats.frames_failed));
+    printf("  \"cpu\": {\"encode_ns_per_byte\":%.3f,\"decode_ns_per_byte\":%.3f}\n", encode_ns / byte_count, decode_ns / byte_count);
+    printf("}\n");
+
+    return 0;
+}
@@ -0,0 +1,37 @@
+#!/bin/sh
+#
+# profile guided build of cm256_codec next to a plain one, then the benchmark of both
+#
+#   bench/pgo.sh [build_dir]        (default build_pgo, extra configure flags through CMAKE_ARGS)
+#
+# base/ is the plain build, pgo/ is configured with CM256_CODEC_PGO=GENERATE, trained by the
+# bench_pgo target (CMakeLists.txt), reconfigured with CM256_CODEC_PGO=USE and rebuilt,
+# both benchmark runs go to base.json and pgo.json and 'cm256_codec_bench compare' reports the speedup
+
+set -e
+
+source_dir=$(cd "$(dirname "$0")/.." && pwd)
+build_dir=${1:-build_pgo}
+mkdir -p "$build_dir"
+build_dir=$(cd "$build_dir" && pwd)
+
+cmake -S "$source_dir" -B "$build_dir/base" -DCM256_CODEC_PGO=OFF $CMAKE_ARGS
+cmake --build "$build_dir/base" -j
+"$build_dir/base/cm256_codec_bench" "$build_dir/base.json"
+
+# stale profiles from an older tree would be read back as if they matched this one
+rm -rf "$build_dir/pgo/pgo"
+cmake -S "$source_dir" -B "$build_dir/pgo" -DCM256_CODEC_PGO=GENERATE $CMAKE_ARGS
+cmake --build "$build_dir/pgo" -j --target bench_pgo
+
+# clang writes raw profiles, USE reads the merged one
+if ls "$build_dir/pgo/pgo/"*.profraw >/dev/null 2>&1; then
+    llvm-profdata merge -output="$build_dir/pgo/pgo/default.profdata" "$build_dir/pgo/pgo/"*.profraw
+fi
+
+cmake -S "$source_dir" -B "$build_dir/pgo" -DCM256_CODEC_PGO=USE $CMAKE_ARGS
+cmake --build "$build_dir/pgo" -j
+ctest --test-dir "$build_dir/pgo" --output-on-failure
+"$build_dir/pgo/cm256_codec_bench" "$build_dir/pgo.json"
+
+"$build_dir/pgo/cm256_codec_bench" compare "$build_dir/base.json" "$build_dir/pgo.json"
@@ -0,0 +1,107 @@
+/********************************************************
+ * Description : cm256 codec decode fuzzer
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#include <cstdio>
+#include "cm256_codec.h"
+#include "cm256_wire.h"
+
+/*
+ * libFuzzer target: the input is a run of datagrams, each a little endian 16-bit length and its bytes,
+ * fed to cm256_decode, to a decoder session and, through the version 2 wire format, to a second session,
+ * the clock moves one millisecond per datagram so a crash replays the same way,
+ * build with CM256_FUZZ_STANDALONE to replay files without libFuzzer
+ */
+
+static uint64_t s_fuzz_microseconds = 0;
+
+static void CM256_CODEC_CDECL get_fuzz_time(uint32_t & seconds, uint32_t & microseconds)
+{
+    seconds = static_cast<uint32_t>(s_fuzz_microseconds / 1000000);
+    microseconds = static_cast<uint32_t>(s_fuzz_microseconds % 1000000);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t * data, std::size_t size)
+{
+    cm256_set_clock(&get_fuzz_time);
+    s_fuzz_microseconds = 0;
+
+    wire_format_t format;
+    format.version = 2;
+    format.block_bytes = 64;
+    format.original_count = 4;
+    format.recovery_count = 2;
+
+    frames_t frames;
+    cm256_decoder_t * decoder = cm256_decoder_create(1000 * 5, 8, 1024 * 64);
+    cm256_decoder_t * wire_decoder = cm256_decoder_create(1000 * 5, 8, 1024 * 64);
+    cm256_decoder_set_wire_format(wire_decoder, format);
+    if (0 != size && 0 != (data[0] & 1))
+    {
+        cm256_decoder_set_in_order(decoder, true, 4, 1000 * 5);
+    }
+
+    std::list<std::vector<uint8_t>> dst_data_list;
+    std::size_t offset = 0;
+    while (offset + 2 <= size)
+    {
+        std::size_t data_len = data[offset] | (static_cast<std::size_t>(data[offset + 1]) << 8);
+        offset += 2;
+        if (data_len > size - offset)
+        {
+            data_len = size - offset;
+        }
+
+        /* copied out, so a read past the datagram is a read past its own allocation */
+        const std::vector<uint8_t> datagram(data + offset, data + offset + data_len);
+        const void * datagram_data = (datagram.empty() ? nullptr : datagram.data());
+        offset += data_len;
+
+        s_fuzz_microseconds += 1000;
+        cm256_decode(datagram_data, datagram.size(), frames, dst_data_list, 1000 * 5, false);
+        cm256_decoder_decode(decoder, datagram_data, datagram.size(), dst_data_list);
+        cm256_decoder_decode(wire_decoder, datagram_data, datagram.size(), dst_data_list);
+        dst_data_list.clear();
+    }
+
+    cm256_decode(nullptr, 0, frames, dst_data_list, 1000 * 5, true);
+    cm256_decoder_flush(decoder, dst_data_list);
+    cm256_decoder_flush(wire_decoder, dst_data_list);
+    cm256_decoder_destroy(decoder);
+    cm256_decoder_destroy(wire_decoder);
+    cm256_set_clock(nullptr);
+
+    return 0;
+}
+
+#ifdef CM256_FUZZ_STANDALONE
+
+int main(int argc, char * argv[])
+{
+    for (int index = 1; index < argc; ++index)
+    {
+        FILE * file = fopen(argv[index], "rb");
+        if (nullptr == file)
+        {
+            fprintf(stderr, "cannot open %s\n", argv[index]);
+            return 1;
+        }
+        std::vector<uint8_t> input;
+        uint8_t buffer[4096];
+        std::size_t read_bytes = 0;
+        while (0 != (read_bytes = fread(buffer, 1, sizeof(buffer), file)))
+        {
+            input.insert(input.end(), buffer, buffer + read_bytes);
+        }
+        fclose(file);
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+    return 0;
+}
+
+#endif // CM256_FUZZ_STANDALONE
@@ -112,6 +112,50 @@ public:
         cm256_block* originals,      // Array of pointers to original blocks
         uint8_t ** recoveryBlocks);  // Output recovery blocks array
 
+    /*
+     * Cauchy MDS GF(256) padding-aware encode
+     *
+     * Same as cm256_encode(), but original j only holds data in its first
+     * originalBytes[j] bytes and is zero after that.  The zero tails are
+     * never read, so short originals cost only their own length in the GF
+     * kernels, and the recovery blocks are identical to cm256_encode() on
+     * the zero-padded originals.
+     *
+     * Precondition: 0 <= originalBytes[j] <= blockBytes
+     *
+     * Returns 0 on success, and any other code indicates failure.
+     */
+    int cm256_encode(
+        cm256_encoder_params params, // Encoder parameters
+        cm256_block* originals,      // Array of pointers to original blocks
+        uint8_t ** recoveryBlocks,   // Output recovery blocks array
+        const int* originalBytes);   // Non-zero prefix length of each original
+
+    /*
+     * Cauchy MDS GF(256) incremental encode
+     *
+     * This adds the contribution of a single original block to every recovery
+     * block, so that originals can be folded in one by one as they arrive and
+     * the recovery blocks are complete once the last original is accumulated.
+     *
+     * The recovery blocks must be zero-filled before the first original is
+     * accumulated.  Each original must be accumulated exactly once, in any
+     * order, and the result is identical to cm256_encode().
+     *
+     * Returns 0 on success, and any other code indicates failure.
+     */
+    int cm256_encode_accumulate(
+        cm256_encoder_params params, // Encoder parameters
+        const cm256_block& original, // Original block, Index in [0..(originalCount-1)]
+        uint8_t ** recoveryBlocks);  // Output recovery blocks array
+
+    // Same as above for an original that is zero after its first originalBytes bytes
+    int cm256_encode_accumulate(
+        cm256_encoder_params params, // Encoder parameters
+        const cm256_block& original, // Original block, Index in [0..(originalCount-1)]
+        uint8_t ** recoveryBlocks,   // Output recovery blocks array
+        int originalBytes);          // Non-zero prefix length of the original
+
     /*
      * Cauchy MDS GF(256) decode
      *
@@ -134,6 +178,21 @@ public:
         cm256_encoder_params params, // Encoder parameters
         cm256_block* blocks);        // Array of 'originalCount' blocks as described above
 
+    /*
+     * Cauchy MDS GF(256) padding-aware decode
+     *
+     * Same as cm256_decode(), but the original block in blocks[i] is zero
+     * after its first blockBytes[i] bytes, so eliminating it from the
+     * recovery blocks only touches that prefix.  Entries for recovery
+     * blocks are ignored, recovered originals are always full length.
+     *
+     * Returns 0 on success, and any other code indicates failure.
+     */
+    int cm256_decode(
+        cm256_encoder_params params, // Encoder parameters
+        cm256_block* blocks,         // Array of 'originalCount' blocks as described above
+        const int* blockBytes);      // Non-zero prefix length of each original in 'blocks'
+
     /*
      * Commodity functions
      */
@@ -166,13 +225,14 @@ private:
 
         // Original blocks
         cm256_block* Original[256];
+        int OriginalBytes[256];
         int OriginalCount;
 
         // Row indices that were erased
         uint8_t ErasuresIndices[256];
 
         // Initialize the decoder
-        bool Initialize(cm256_encoder_params& params, cm256_block* blocks);
+        bool Initialize(cm256_encoder_params& params, cm256_block* blocks, const int* blockBytes);
 
         // Decode m=1 case
         void DecodeM1();
@@ -193,7 +253,8 @@ private:
         cm256_encoder_params params, // Encoder parameters
         cm256_block* originals,      // Array of pointers to original blocks
         int recoveryBlockIndex,      // Return value from cm256_get_recovery_block_index()
-        void* recoveryBlock);        // Output recovery block
+        void* recoveryBlock,         // Output recovery block
+        const int* originalBytes);   // Non-zero prefix lengths, nullptr for full blocks
 
     gf256_ctx m_gf256Ctx;
     bool m_initialized;
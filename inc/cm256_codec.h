@@ -34,6 +34,7 @@
 #include <map>
 #include <list>
 #include <vector>
+#include "cm256_stats.h"
 
 struct CM256_CODEC_TYPE frame_header_t
 {
@@ -65,15 +66,122 @@ struct decode_timer_t
     uint16_t                            frame_index;
     uint32_t                            decode_seconds;
     uint32_t                            decode_microseconds;
+    uint32_t                            start_seconds;
+    uint32_t                            start_microseconds;
+};
+
+struct decode_counters_t
+{
+    stats_counter_t                     blocks_received;
+    stats_counter_t                     blocks_duplicate;
+    stats_counter_t                     blocks_late;
+    stats_counter_t                     blocks_mismatch;
+    stats_counter_t                     blocks_corrupt;
+    stats_counter_t                     blocks_malformed;
+    stats_counter_t                     blocks_recovered;
+    stats_counter_t                     frames_complete;
+    stats_counter_t                     frames_recovered;
+    stats_counter_t                     frames_expired;
+    stats_counter_t                     frames_failed;
+    stats_counter_t                     frames_evicted;
+    stats_counter_t                     frames_skipped;
+    stats_counter_t                     frames_late;
+    stats_histogram_counter_t           frame_microseconds;
+    stats_histogram_counter_t           decode_nanoseconds;
+    stats_histogram_counter_t           recovered_blocks;
 };
 
 struct frames_t
 {
     std::map<uint16_t, frame_t>         item;
     std::list<decode_timer_t>           decode_timer_list;
+    decode_counters_t                   stats;
+};
+
+/*
+ * blocks_duplicate: already held, blocks_late: frame already delivered, blocks_mismatch: header disagrees with the frame,
+ * blocks_corrupt: failed the crc32c trailer of the session's wire format (see cm256_wire.h), blocks_malformed: truncated or impossible header,
+ * frames_complete/expired/evicted: delivered whole / at the deadline / under memory pressure, frame_microseconds: first block to delivery,
+ * frames_skipped/late: in-order delivery gave up waiting for a frame / dropped a frame that came after its turn,
+ * decode_nanoseconds and recovered_blocks: per frame that needed recovery
+ */
+struct CM256_CODEC_TYPE decode_stats_t
+{
+    uint64_t                            blocks_received;
+    uint64_t                            blocks_duplicate;
+    uint64_t                            blocks_late;
+    uint64_t                            blocks_mismatch;
+    uint64_t                            blocks_corrupt;
+    uint64_t                            blocks_malformed;
+    uint64_t                            blocks_recovered;
+    uint64_t                            frames_complete;
+    uint64_t                            frames_recovered;
+    uint64_t                            frames_expired;
+    uint64_t                            frames_failed;
+    uint64_t                            frames_evicted;
+    uint64_t                            frames_skipped;
+    uint64_t                            frames_late;
+    stats_histogram_t                   frame_microseconds;
+    stats_histogram_t                   decode_nanoseconds;
+    stats_histogram_t                   recovered_blocks;
+};
+
+/*
+ * per frame timings of the encoders, recovery_nanoseconds covers the recovery buffers and cm256_nanoseconds,
+ * the encode calls of all threads are aggregated
+ */
+struct CM256_CODEC_TYPE encode_profile_t
+{
+    uint64_t                            original_bytes;
+    stats_histogram_t                   original_nanoseconds;
+    stats_histogram_t                   recovery_nanoseconds;
+    stats_histogram_t                   cm256_nanoseconds;
+    stats_histogram_t                   splice_nanoseconds;
+};
+
+struct cm256_decoder_t;
+
+struct cm256_parallel_decoder_t;
+
+struct CM256_CODEC_TYPE stream_encoder_t
+{
+    uint16_t                            frame_index;
+    uint8_t                             frame_filter;
+    uint8_t                             original_count;
+    uint8_t                             recovery_count;
+    uint16_t                            block_bytes;
+    double                              recovery_rate;
+    bool                                recovery_force;
+    uint32_t                            flush_seconds;
+    uint32_t                            flush_microseconds;
+    std::list<std::vector<uint8_t>>     original_list;
+    std::list<std::vector<uint8_t>>     recovery_list;
+
+    stream_encoder_t();
 };
 
+typedef void (CM256_CODEC_CDECL * cm256_clock_t)(uint32_t & seconds, uint32_t & microseconds);
 
+
+/*
+ * frame deadlines of the encoders and decoders follow the wall clock, a simulator may install
+ * its own clock (nullptr restores the wall clock), do not swap it while codec calls are running
+ */
+CM256_CODEC_CXX_API(void)
+cm256_set_clock(
+    cm256_clock_t clock
+);
+
+CM256_CODEC_CXX_API(void)
+cm256_get_time(
+    uint32_t & seconds, 
+    uint32_t & microseconds
+);
+
+/*
+ * frames hold up to 255 blocks by default, max_original_count and max_frame_bytes
+ * (original block bytes per frame, headers included) shrink them to bound repair latency
+ */
 CM256_CODEC_CXX_API(bool)
 cm256_encode(
     uint16_t & frame_index, 
@@ -82,7 +190,18 @@ cm256_encode(
     const std::list<std::vector<uint8_t>> & src_data_list, 
     double recovery_rate, 
     std::size_t max_data_size = 0, 
-    bool recovery_force = false
+    bool recovery_force = false, 
+    std::size_t max_original_count = 0, 
+    std::size_t max_frame_bytes = 0
+);
+
+/*
+ * the probes are only built with CM256_CODEC_PROFILE defined (make profile=yes),
+ * otherwise the profile is zeroed and false returned
+ */
+CM256_CODEC_CXX_API(bool)
+cm256_encode_profile(
+    encode_profile_t & profile
 );
 
 CM256_CODEC_CXX_API(bool)
@@ -95,5 +214,132 @@ cm256_decode(
     bool recovery_force = false
 );
 
+/*
+ * counters accumulate over the life of frames, a snapshot may be taken from any thread while decoding,
+ * each value is read atomically but the snapshot as a whole is not
+ */
+CM256_CODEC_CXX_API(void)
+cm256_decode_stats(
+    const frames_t & frames, 
+    decode_stats_t & stats
+);
+
+/*
+ * streaming encoder: each packet goes out as an original block at once, recovery blocks follow
+ * when the frame holds max_original_count originals or max_delay_microseconds after its first one,
+ * call with data == nullptr to poll the deadline and cm256_stream_flush() to close the frame now,
+ * recovery of a full frame is accumulated as its originals arrive so closing it costs no coding
+ */
+CM256_CODEC_CXX_API(bool)
+cm256_stream_encode(
+    const void * data, 
+    std::size_t data_len, 
+    stream_encoder_t & encoder, 
+    std::list<std::vector<uint8_t>> & dst_data_list, 
+    double recovery_rate, 
+    std::size_t max_data_size, 
+    std::size_t max_original_count = 0, 
+    uint32_t max_delay_microseconds = 1000 * 15, 
+    bool recovery_force = false
+);
+
+CM256_CODEC_CXX_API(bool)
+cm256_stream_flush(
+    stream_encoder_t & encoder, 
+    std::list<std::vector<uint8_t>> & dst_data_list
+);
+
+/*
+ * decoder session: same decoding as cm256_decode() over private frames, with at most max_frame_count
+ * frames in flight and max_buffer_bytes of blocks buffered, beyond either the oldest incomplete frame
+ * is evicted and its originals delivered, as when its deadline expires
+ */
+CM256_CODEC_CXX_API(cm256_decoder_t *)
+cm256_decoder_create(
+    uint32_t max_delay_microseconds = 1000 * 15, 
+    std::size_t max_frame_count = 64, 
+    std::size_t max_buffer_bytes = 1024 * 1024 * 16
+);
+
+CM256_CODEC_CXX_API(void)
+cm256_decoder_destroy(
+    cm256_decoder_t * decoder
+);
+
+CM256_CODEC_CXX_API(bool)
+cm256_decoder_decode(
+    cm256_decoder_t * decoder, 
+    const void * data, 
+    std::size_t data_len, 
+    std::list<std::vector<uint8_t>> & dst_data_list, 
+    bool recovery_force = false
+);
+
+/*
+ * in-order mode: payloads leave in (frame_index, block_index) order starting at the first frame a block is seen of,
+ * a decoded frame is held back until the frames before it are out, a frame with blocks in flight is waited for until
+ * its decode deadline, a frame never seen is skipped once one has waited max_hold_microseconds, and any missing frame
+ * once more than max_hold_frames are held, a frame decoded after its turn is dropped
+ */
+CM256_CODEC_CXX_API(bool)
+cm256_decoder_set_in_order(
+    cm256_decoder_t * decoder, 
+    bool in_order, 
+    std::size_t max_hold_frames = 64, 
+    uint32_t max_hold_microseconds = 1000 * 15
+);
+
+/* delivers every frame in flight now, complete or not */
+CM256_CODEC_CXX_API(bool)
+cm256_decoder_flush(
+    cm256_decoder_t * decoder, 
+    std::list<std::vector<uint8_t>> & dst_data_list
+);
+
+CM256_CODEC_CXX_API(bool)
+cm256_decoder_stats(
+    const cm256_decoder_t * decoder, 
+    decode_stats_t & stats
+);
+
+/*
+ * one stream decoded by a pool of workers: decode/flush/stats belong to a single receive thread, which inserts blocks,
+ * hands finished frames to the workers and gets the output back in the order cm256_decode would produce it,
+ * decode blocks only while max_pending_count frames are still with the workers
+ */
+CM256_CODEC_CXX_API(cm256_parallel_decoder_t *)
+cm256_parallel_decoder_create(
+    std::size_t worker_count, 
+    uint32_t max_delay_microseconds = 15000, 
+    std::size_t max_pending_count = 256
+);
+
+CM256_CODEC_CXX_API(void)
+cm256_parallel_decoder_destroy(
+    cm256_parallel_decoder_t * decoder
+);
+
+CM256_CODEC_CXX_API(bool)
+cm256_parallel_decoder_decode(
+    cm256_parallel_decoder_t * decoder, 
+    const void * data, 
+    std::size_t data_len, 
+    std::list<std::vector<uint8_t>> & dst_data_list, 
+    bool recovery_force = false
+);
+
+/* delivers every frame in flight now and waits for the workers to finish them */
+CM256_CODEC_CXX_API(bool)
+cm256_parallel_decoder_flush(
+    cm256_parallel_decoder_t * decoder, 
+    std::list<std::vector<uint8_t>> & dst_data_list
+);
+
+CM256_CODEC_CXX_API(bool)
+cm256_parallel_decoder_stats(
+    const cm256_parallel_decoder_t * decoder, 
+    decode_stats_t & stats
+);
+
 
 #endif // CM256_CODEC_H
@@ -0,0 +1,28 @@
+/********************************************************
+ * Description : crc32c (castagnoli) checksum
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#ifndef CM256_CRC32C_H
+#define CM256_CRC32C_H
+
+
+#include "cm256_codec.h"
+
+/*
+ * crc32c of data, continued from crc (0 to start), the sse4.2 crc32 instruction is used
+ * when the cpu has it, whatever the build flags, otherwise a slicing-by-8 table
+ */
+CM256_CODEC_CXX_API(uint32_t)
+cm256_crc32c(
+    const void * data, 
+    std::size_t data_len, 
+    uint32_t crc = 0
+);
+
+
+#endif // CM256_CRC32C_H
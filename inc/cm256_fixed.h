@@ -0,0 +1,264 @@
+/********************************************************
+ * Description : Cauchy MDS GF(256) codec for a fixed shape
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#ifndef CM256_FIXED_H
+#define CM256_FIXED_H
+
+#include "cm256.h"
+
+/*
+ * GF(256) arithmetic as constant expressions, over gf256_ctx::Polynomial,
+ * so the matrix elements below are the ones gf256_ctx::getMatrixElement()
+ * looks up at run time
+ */
+namespace cm256_fixed
+{
+    constexpr unsigned gf256_xtime(unsigned x)
+    {
+        return (x & 0x80) ? (((x << 1) ^ gf256_ctx::Polynomial) & 0xff) : (x << 1);
+    }
+
+    constexpr unsigned gf256_mul_step(unsigned x, unsigned y, unsigned product)
+    {
+        return 0 == y ? product : gf256_mul_step(gf256_xtime(x), y >> 1, (y & 1) ? (product ^ x) : product);
+    }
+
+    constexpr uint8_t gf256_mul(unsigned x, unsigned y)
+    {
+        return static_cast<uint8_t>(gf256_mul_step(x, y, 0));
+    }
+
+    // x^n by squaring, x^254 is the inverse of x
+    constexpr uint8_t gf256_pow(unsigned x, unsigned n)
+    {
+        return 0 == n ? 1 : gf256_mul(gf256_pow(gf256_mul(x, x), n >> 1), (n & 1) ? x : 1);
+    }
+
+    constexpr uint8_t gf256_div(unsigned x, unsigned y)
+    {
+        return gf256_mul(x, gf256_pow(y, 254));
+    }
+
+    // Same as gf256_ctx::getMatrixElement(x_i, x_0, y_j)
+    constexpr uint8_t getMatrixElement(unsigned x_i, unsigned x_0, unsigned y_j)
+    {
+        return gf256_div(y_j ^ x_0, x_i ^ y_j);
+    }
+
+#if defined(USE_SSSE3) || defined(USE_NEON)
+
+    // sum += x * Y, Y is a constant so its nibble tables are vector constants
+    template <uint8_t Y>
+    struct product_t
+    {
+        static GF256_FORCE_INLINE void muladd(GF256_M128& sum, GF256_M128 /*x*/, GF256_M128 x_lo, GF256_M128 x_hi)
+        {
+            const GF256_M128 table_lo_y = _mm_setr_epi8(
+                gf256_mul(0x00, Y), gf256_mul(0x01, Y), gf256_mul(0x02, Y), gf256_mul(0x03, Y),
+                gf256_mul(0x04, Y), gf256_mul(0x05, Y), gf256_mul(0x06, Y), gf256_mul(0x07, Y),
+                gf256_mul(0x08, Y), gf256_mul(0x09, Y), gf256_mul(0x0a, Y), gf256_mul(0x0b, Y),
+                gf256_mul(0x0c, Y), gf256_mul(0x0d, Y), gf256_mul(0x0e, Y), gf256_mul(0x0f, Y));
+            const GF256_M128 table_hi_y = _mm_setr_epi8(
+                gf256_mul(0x00, Y), gf256_mul(0x10, Y), gf256_mul(0x20, Y), gf256_mul(0x30, Y),
+                gf256_mul(0x40, Y), gf256_mul(0x50, Y), gf256_mul(0x60, Y), gf256_mul(0x70, Y),
+                gf256_mul(0x80, Y), gf256_mul(0x90, Y), gf256_mul(0xa0, Y), gf256_mul(0xb0, Y),
+                gf256_mul(0xc0, Y), gf256_mul(0xd0, Y), gf256_mul(0xe0, Y), gf256_mul(0xf0, Y));
+            sum = _mm_xor_si128(sum, _mm_xor_si128(_mm_shuffle_epi8(table_lo_y, x_lo), _mm_shuffle_epi8(table_hi_y, x_hi)));
+        }
+    };
+
+    // The first recovery row is all ones: parity
+    template <>
+    struct product_t<1>
+    {
+        static GF256_FORCE_INLINE void muladd(GF256_M128& sum, GF256_M128 x, GF256_M128 /*x_lo*/, GF256_M128 /*x_hi*/)
+        {
+            sum = _mm_xor_si128(sum, x);
+        }
+    };
+
+    // Adds original J to recovery rows R..M-1
+    template <int K, int M, int R, int J>
+    struct rows_t
+    {
+        static GF256_FORCE_INLINE void muladd(GF256_M128* sum, GF256_M128 x, GF256_M128 x_lo, GF256_M128 x_hi)
+        {
+            product_t<getMatrixElement(K + R, K, J)>::muladd(sum[R], x, x_lo, x_hi);
+            rows_t<K, M, R + 1, J>::muladd(sum, x, x_lo, x_hi);
+        }
+    };
+
+    template <int K, int M, int J>
+    struct rows_t<K, M, M, J>
+    {
+        static GF256_FORCE_INLINE void muladd(GF256_M128* /*sum*/, GF256_M128 /*x*/, GF256_M128 /*x_lo*/, GF256_M128 /*x_hi*/)
+        {
+        }
+    };
+
+    // Adds 16 bytes at offset of originals 0..J-1 to every recovery row, each original is loaded once
+    template <int K, int M, int J>
+    struct columns_t
+    {
+        static GF256_FORCE_INLINE void muladd(GF256_M128* sum, const CM256::cm256_block* originals, int offset)
+        {
+            columns_t<K, M, J - 1>::muladd(sum, originals, offset);
+
+            const GF256_M128 clr_mask = _mm_set1_epi8(0x0f);
+            const GF256_M128 x = _mm_loadu_si128(reinterpret_cast<const GF256_M128*>(static_cast<const uint8_t*>(originals[J - 1].Block) + offset));
+            const GF256_M128 x_lo = _mm_and_si128(x, clr_mask);
+            const GF256_M128 x_hi = _mm_and_si128(_mm_srli_epi64(x, 4), clr_mask);
+            rows_t<K, M, 0, J - 1>::muladd(sum, x, x_lo, x_hi);
+        }
+    };
+
+    template <int K, int M>
+    struct columns_t<K, M, 0>
+    {
+        static GF256_FORCE_INLINE void muladd(GF256_M128* /*sum*/, const CM256::cm256_block* /*originals*/, int /*offset*/)
+        {
+        }
+    };
+
+#endif // USE_SSSE3 || USE_NEON
+}
+
+/*
+ * Cauchy MDS GF(256) codec with the shape fixed at compile time
+ *
+ * Produces the same recovery blocks as CM256::cm256_encode() with
+ * OriginalCount = K, RecoveryCount = M and BlockBytes = BlockBytes.  The
+ * matrix elements and their multiplication tables are constant
+ * expressions, and the loops over originals and recovery rows are unrolled
+ * in one pass: each 16 bytes of an original are loaded once and folded into
+ * all M recovery rows held in registers, instead of one pass over the block
+ * per matrix element.  The unrolled body grows as K * M, so this is meant
+ * for the few small shapes a stream settles on, e.g. CM256Fixed<20, 4, 1200>.
+ *
+ * The erasure pattern is only known at run time, so cm256_decode() forwards
+ * to CM256::cm256_decode() with the fixed parameters.
+ */
+template <int K, int M, int BlockBytes>
+class CM256Fixed
+{
+    static_assert(K > 0 && M > 0 && K + M <= 256, "CM256Fixed: K + M must not exceed 256");
+    static_assert(BlockBytes > 0, "CM256Fixed: BlockBytes must be positive");
+
+public:
+    static const int OriginalCount = K;
+    static const int RecoveryCount = M;
+    static const int BlockSize = BlockBytes;
+
+    bool isInitialized() const { return m_cm256.isInitialized(); };
+
+    static CM256::cm256_encoder_params params()
+    {
+        CM256::cm256_encoder_params params = { K, M, BlockBytes };
+        return params;
+    }
+
+    // Element of recovery row recoveryIndex (0-based) and original column originalIndex
+    static constexpr uint8_t getMatrixElement(int recoveryIndex, int originalIndex)
+    {
+        return cm256_fixed::getMatrixElement(static_cast<unsigned>(K + recoveryIndex), static_cast<unsigned>(K), static_cast<unsigned>(originalIndex));
+    }
+
+    /*
+     * Same contract as CM256::cm256_encode() for the fixed shape: originals
+     * holds K blocks of BlockBytes bytes, recoveryBlocks M outputs.
+     *
+     * Returns 0 on success, and any other code indicates failure.
+     */
+    int cm256_encode(
+        CM256::cm256_block* originals, // Array of K pointers to original blocks
+        uint8_t ** recoveryBlocks)     // Output array of M recovery blocks
+    {
+        if (!originals || !recoveryBlocks)
+        {
+            return -3;
+        }
+
+        // One original: every recovery block is a copy, as CM256 does
+        if (K == 1)
+        {
+            for (int i = 0; i < M; ++i)
+            {
+                memcpy(recoveryBlocks[i], originals[0].Block, BlockBytes);
+            }
+            return 0;
+        }
+
+#if defined(USE_SSSE3) || defined(USE_NEON)
+        int offset = 0;
+        for (; offset + 16 <= BlockBytes; offset += 16)
+        {
+            GF256_M128 sum[M];
+            for (int i = 0; i < M; ++i)
+            {
+                sum[i] = _mm_setzero_si128();
+            }
+            cm256_fixed::columns_t<K, M, K>::muladd(sum, originals, offset);
+            for (int i = 0; i < M; ++i)
+            {
+                _mm_storeu_si128(reinterpret_cast<GF256_M128*>(recoveryBlocks[i] + offset), sum[i]);
+            }
+        }
+
+        // Tail: the same pass over zero-padded copies of the last bytes
+        const int tailBytes = BlockBytes - offset;
+        if (tailBytes > 0)
+        {
+            GF256_ALIGNED uint8_t tailData[K][16];
+            CM256::cm256_block tail[K];
+            for (int j = 0; j < K; ++j)
+            {
+                memcpy(tailData[j], static_cast<const uint8_t*>(originals[j].Block) + offset, tailBytes);
+                memset(tailData[j] + tailBytes, 0, 16 - tailBytes);
+                tail[j].Block = tailData[j];
+                tail[j].Index = static_cast<unsigned char>(j);
+            }
+
+            GF256_M128 sum[M];
+            for (int i = 0; i < M; ++i)
+            {
+                sum[i] = _mm_setzero_si128();
+            }
+            cm256_fixed::columns_t<K, M, K>::muladd(sum, tail, 0);
+            for (int i = 0; i < M; ++i)
+            {
+                GF256_ALIGNED uint8_t tailSum[16];
+                _mm_store_si128(reinterpret_cast<GF256_M128*>(tailSum), sum[i]);
+                memcpy(recoveryBlocks[i] + offset, tailSum, tailBytes);
+            }
+        }
+
+        return 0;
+#else
+        return m_cm256.cm256_encode(params(), originals, recoveryBlocks);
+#endif // USE_SSSE3 || USE_NEON
+    }
+
+    /*
+     * Same contract as CM256::cm256_decode() for the fixed shape: blocks
+     * holds K received blocks, recovered originals replace recovery blocks.
+     *
+     * Returns 0 on success, and any other code indicates failure.
+     */
+    int cm256_decode(
+        CM256::cm256_block* blocks)    // Array of K blocks as described above
+    {
+        return m_cm256.cm256_decode(params(), blocks);
+    }
+
+private:
+    CM256 m_cm256;
+};
+
+
+#endif // CM256_FIXED_H
@@ -0,0 +1,60 @@
+/********************************************************
+ * Description : cm256 multi-stream decoder
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#ifndef CM256_MULTI_H
+#define CM256_MULTI_H
+
+
+#include "cm256_codec.h"
+
+struct cm256_multi_decoder_t;
+
+/* called on a shard thread with everything one stream delivered in a batch, the list may be spliced away */
+typedef void (CM256_CODEC_CDECL * cm256_multi_deliver_t)(void * context, uint64_t stream_id, std::list<std::vector<uint8_t>> & dst_data_list);
+
+/*
+ * multi-stream decoder: every stream id is owned by one of shard_count threads, each running its
+ * streams' decoder sessions (see cm256_decoder_create) without locks, blocks reach a shard through
+ * a lock-free mpsc queue, so cm256_multi_decoder_push() may be called from any number of threads,
+ * the shard also expires frames every poll_microseconds and delivers each batch per stream
+ */
+CM256_CODEC_CXX_API(cm256_multi_decoder_t *)
+cm256_multi_decoder_create(
+    std::size_t shard_count, 
+    cm256_multi_deliver_t deliver, 
+    void * context, 
+    uint32_t max_delay_microseconds = 1000 * 15, 
+    std::size_t max_frame_count = 64, 
+    std::size_t max_buffer_bytes = 1024 * 1024 * 16, 
+    uint32_t poll_microseconds = 1000 * 5
+);
+
+/* blocks still queued are decoded, frames still incomplete are dropped */
+CM256_CODEC_CXX_API(void)
+cm256_multi_decoder_destroy(
+    cm256_multi_decoder_t * decoder
+);
+
+CM256_CODEC_CXX_API(bool)
+cm256_multi_decoder_push(
+    cm256_multi_decoder_t * decoder, 
+    uint64_t stream_id, 
+    const void * data, 
+    std::size_t data_len
+);
+
+/* delivers what the stream holds, including incomplete frames, and releases its session */
+CM256_CODEC_CXX_API(bool)
+cm256_multi_decoder_close(
+    cm256_multi_decoder_t * decoder, 
+    uint64_t stream_id
+);
+
+
+#endif // CM256_MULTI_H
@@ -0,0 +1,69 @@
+/********************************************************
+ * Description : cm256 message packer
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#ifndef CM256_PACKER_H
+#define CM256_PACKER_H
+
+
+#include "cm256_codec.h"
+
+struct CM256_CODEC_TYPE packer_t
+{
+    uint32_t                            sequence;
+    std::vector<uint8_t>                block;
+
+    packer_t();
+};
+
+struct CM256_CODEC_TYPE unpacker_t
+{
+    bool                                started;
+    uint32_t                            sequence;
+    bool                                assembling;
+    bool                                skipping;
+    std::vector<uint8_t>                message;
+    uint64_t                            dropped_count;
+
+    unpacker_t();
+};
+
+/*
+ * message packer: messages of any size are cut into fragments and small ones share blocks, so every block
+ * but the last of a flush is block_bytes long and cm256_encode() with max_data_size = block_bytes pads nothing,
+ * a block that is not full waits in the packer for the next message or for cm256_pack_flush()
+ */
+CM256_CODEC_CXX_API(bool)
+cm256_pack(
+    const void * data, 
+    std::size_t data_len, 
+    packer_t & packer, 
+    std::list<std::vector<uint8_t>> & dst_block_list, 
+    std::size_t block_bytes = 1400
+);
+
+CM256_CODEC_CXX_API(bool)
+cm256_pack_flush(
+    packer_t & packer, 
+    std::list<std::vector<uint8_t>> & dst_block_list
+);
+
+/*
+ * blocks must come in the order they were packed (see cm256_decoder_set_in_order), a block missing from the
+ * sequence drops the messages it carried part of, dropped_count counts the messages received only in part
+ */
+CM256_CODEC_CXX_API(bool)
+cm256_unpack(
+    const void * data, 
+    std::size_t data_len, 
+    unpacker_t & unpacker, 
+    std::list<std::vector<uint8_t>> & dst_message_list
+);
+
+
+#endif // CM256_PACKER_H
@@ -0,0 +1,61 @@
+/********************************************************
+ * Description : cm256 encode and send pipeline
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#ifndef CM256_PIPELINE_H
+#define CM256_PIPELINE_H
+
+
+#include "cm256_codec.h"
+
+struct cm256_pipeline_t;
+
+/* called on the sender thread with up to max_batch_count blocks in the order they were encoded */
+typedef void (CM256_CODEC_CDECL * cm256_pipeline_send_t)(void * context, const std::list<std::vector<uint8_t>> & data_list);
+
+/*
+ * encode and send pipeline: payloads pushed by one thread go through a lock-free spsc ring to an encoder
+ * thread running a streaming encoder (see cm256_stream_encode), its blocks go through a second spsc ring
+ * to a sender thread, so originals are on the wire while the encoder is still busy with recovery,
+ * each ring holds queue_block_count entries and a full ring makes its producer wait
+ */
+CM256_CODEC_CXX_API(cm256_pipeline_t *)
+cm256_pipeline_create(
+    cm256_pipeline_send_t send, 
+    void * context, 
+    double recovery_rate, 
+    std::size_t max_data_size, 
+    std::size_t max_original_count = 0, 
+    uint32_t max_delay_microseconds = 1000 * 15, 
+    bool recovery_force = false, 
+    std::size_t queue_block_count = 1024, 
+    std::size_t max_batch_count = 64
+);
+
+/* payloads still queued are encoded and sent, the open frame is closed first */
+CM256_CODEC_CXX_API(void)
+cm256_pipeline_destroy(
+    cm256_pipeline_t * pipeline
+);
+
+/* must be called from one thread at a time, as must flush */
+CM256_CODEC_CXX_API(bool)
+cm256_pipeline_push(
+    cm256_pipeline_t * pipeline, 
+    const void * data, 
+    std::size_t data_len
+);
+
+/* closes the open frame and waits until every block pushed so far has been handed to send */
+CM256_CODEC_CXX_API(bool)
+cm256_pipeline_flush(
+    cm256_pipeline_t * pipeline
+);
+
+
+#endif // CM256_PIPELINE_H
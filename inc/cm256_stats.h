@@ -0,0 +1,138 @@
+/********************************************************
+ * Description : cm256 codec statistics
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#ifndef CM256_STATS_H
+#define CM256_STATS_H
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif // _MSC_VER
+
+/*
+ * counters have a single writer (the thread driving the codec) and any number of readers,
+ * so an update is a relaxed load and store rather than a locked read-modify-write,
+ * add_shared() is for the few counters that several threads update
+ */
+class stats_counter_t
+{
+public:
+    stats_counter_t()
+        : m_value(0)
+    {
+    }
+
+    stats_counter_t(const stats_counter_t & other)
+        : m_value(other.load())
+    {
+    }
+
+    stats_counter_t & operator=(const stats_counter_t & other)
+    {
+        m_value.store(other.load(), std::memory_order_relaxed);
+        return *this;
+    }
+
+    void add(uint64_t value)
+    {
+        m_value.store(m_value.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    void add_shared(uint64_t value)
+    {
+        m_value.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    uint64_t load() const
+    {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t>               m_value;
+};
+
+/* log2 buckets: bucket 0 counts zeros, bucket i counts values in [2^(i-1), 2^i), the last one is open */
+struct stats_histogram_t
+{
+    uint64_t                            count;
+    uint64_t                            sum;
+    uint64_t                            bucket[32];
+};
+
+struct stats_histogram_counter_t
+{
+    stats_counter_t                     count;
+    stats_counter_t                     sum;
+    stats_counter_t                     bucket[32];
+
+    void add(uint64_t value)
+    {
+        const std::size_t index = get_index(value);
+        count.add(1);
+        sum.add(value);
+        bucket[index].add(1);
+    }
+
+    void add_shared(uint64_t value)
+    {
+        const std::size_t index = get_index(value);
+        count.add_shared(1);
+        sum.add_shared(value);
+        bucket[index].add_shared(1);
+    }
+
+    static std::size_t get_index(uint64_t value)
+    {
+        std::size_t index = 0;
+        if (0 != value)
+        {
+#ifdef _MSC_VER
+            unsigned long bit = 0;
+#ifdef _WIN64
+            _BitScanReverse64(&bit, value);
+#else
+            if (!_BitScanReverse(&bit, static_cast<unsigned long>(value >> 32)))
+            {
+                _BitScanReverse(&bit, static_cast<unsigned long>(value));
+            }
+            else
+            {
+                bit += 32;
+            }
+#endif // _WIN64
+            index = static_cast<std::size_t>(bit) + 1;
+#else
+            index = static_cast<std::size_t>(64 - __builtin_clzll(value));
+#endif // _MSC_VER
+            if (index > 31)
+            {
+                index = 31;
+            }
+        }
+        return index;
+    }
+
+    void load(stats_histogram_t & histogram) const
+    {
+        histogram.count = count.load();
+        histogram.sum = sum.load();
+        for (std::size_t index = 0; index < 32; ++index)
+        {
+            histogram.bucket[index] = bucket[index].load();
+        }
+    }
+};
+
+
+#endif // CM256_STATS_H
@@ -0,0 +1,75 @@
+/********************************************************
+ * Description : cm256 udp transport
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#ifndef CM256_TRANSPORT_H
+#define CM256_TRANSPORT_H
+
+
+#include "cm256_codec.h"
+
+#ifdef _MSC_VER
+    typedef uintptr_t                   cm256_socket_t;
+#else
+    typedef int                         cm256_socket_t;
+#endif // _MSC_VER
+
+struct cm256_transport_t;
+
+/*
+ * udp transport over a datagram socket the caller has bound and connected to its peer and still owns,
+ * on linux blocks leave through sendmmsg, runs of equal sized blocks as one UDP_SEGMENT (gso) send
+ * when use_gso is set and the kernel takes it, and arrive through recvmmsg, up to max_batch_count
+ * datagrams of at most max_datagram_bytes per call, other systems send and receive one datagram per call,
+ * use_uring moves both directions onto an io_uring with max_batch_count registered slots each way,
+ * reads stay posted between calls, and a kernel without io_uring keeps the socket path
+ */
+CM256_CODEC_CXX_API(cm256_transport_t *)
+cm256_transport_create(
+    cm256_socket_t sock, 
+    std::size_t max_batch_count = 64, 
+    std::size_t max_datagram_bytes = 1024 * 64, 
+    bool use_gso = true, 
+    bool use_uring = false
+);
+
+CM256_CODEC_CXX_API(void)
+cm256_transport_destroy(
+    cm256_transport_t * transport
+);
+
+/* tells whether create() got an io_uring or fell back to the socket path */
+CM256_CODEC_CXX_API(bool)
+cm256_transport_uses_uring(
+    const cm256_transport_t * transport
+);
+
+/* sends every block of the list in order, waits as the socket does */
+CM256_CODEC_CXX_API(bool)
+cm256_transport_send(
+    cm256_transport_t * transport, 
+    const std::list<std::vector<uint8_t>> & data_list
+);
+
+/* waits for one datagram as the socket does, then takes what else is queued up to a batch */
+CM256_CODEC_CXX_API(bool)
+cm256_transport_receive(
+    cm256_transport_t * transport, 
+    std::list<std::vector<uint8_t>> & data_list
+);
+
+/* receives a batch and feeds it to the decoder session */
+CM256_CODEC_CXX_API(bool)
+cm256_transport_receive_decode(
+    cm256_transport_t * transport, 
+    cm256_decoder_t * decoder, 
+    std::list<std::vector<uint8_t>> & dst_data_list
+);
+
+
+#endif // CM256_TRANSPORT_H
@@ -0,0 +1,80 @@
+/********************************************************
+ * Description : minimal io_uring ring for the transport
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#ifndef CM256_URING_H
+#define CM256_URING_H
+
+
+#if defined(__linux__) && defined(__has_include)
+    #if __has_include(<linux/io_uring.h>)
+        #define CM256_TRANSPORT_URING
+    #endif // __has_include(<linux/io_uring.h>)
+#endif // __linux__ && __has_include
+
+#ifdef CM256_TRANSPORT_URING
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+/*
+ * one io_uring instance driven through the raw system calls, so no liburing is needed,
+ * the buffers given to create() are registered for the *_FIXED opcodes, in the order given
+ */
+class uring_t
+{
+public:
+    uring_t();
+    ~uring_t();
+
+    bool create(unsigned entries, const struct iovec * buffers, unsigned buffer_count);
+
+    /* a zeroed sqe, or nullptr when the submission ring is full */
+    struct io_uring_sqe * get_sqe();
+
+    /* submits what get_sqe() handed out and waits for wait_count completions, -errno on failure */
+    int enter(unsigned wait_count);
+
+    /* pops one completion */
+    bool pop_cqe(uint64_t & user_data, int & result);
+
+    /* completions waiting in the ring */
+    unsigned ready_count() const;
+
+private:
+    uring_t(const uring_t &);
+    uring_t & operator=(const uring_t &);
+
+    void destroy();
+
+private:
+    int                                 m_fd;
+    void                              * m_sq_ring;
+    std::size_t                         m_sq_ring_bytes;
+    void                              * m_cq_ring;
+    std::size_t                         m_cq_ring_bytes;
+    struct io_uring_sqe               * m_sqes;
+    std::size_t                         m_sqes_bytes;
+    unsigned                          * m_sq_head;
+    unsigned                          * m_sq_tail;
+    unsigned                          * m_sq_array;
+    unsigned                            m_sq_mask;
+    unsigned                            m_sq_entries;
+    unsigned                            m_sq_local_tail;
+    unsigned                          * m_cq_head;
+    unsigned                          * m_cq_tail;
+    struct io_uring_cqe               * m_cqes;
+    unsigned                            m_cq_mask;
+};
+
+#endif // CM256_TRANSPORT_URING
+
+
+#endif // CM256_URING_H
@@ -0,0 +1,71 @@
+/********************************************************
+ * Description : cm256 wide frame codec
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#ifndef CM256_WIDE_H
+#define CM256_WIDE_H
+
+
+#include "cm256_codec.h"
+
+struct CM256_CODEC_TYPE wide_frame_header_t
+{
+    uint16_t                            frame_index;
+    uint8_t                             frame_filter;
+    uint16_t                            original_count;
+    uint16_t                            recovery_count;
+    uint16_t                            block_count;
+    uint16_t                            block_size;
+    std::vector<uint8_t>                block_bitmap;
+
+    wide_frame_header_t();
+};
+
+struct wide_frame_t
+{
+    wide_frame_header_t                 header;
+    frame_body_t                        body;
+};
+
+struct wide_frames_t
+{
+    std::map<uint16_t, wide_frame_t>    item;
+    std::list<decode_timer_t>           decode_timer_list;
+};
+
+/*
+ * wide frames are coded over GF(2^16) and hold up to 65535 blocks, 1024 by default,
+ * max_original_count and max_frame_bytes raise or shrink them like in cm256_encode(),
+ * encoding costs original_count * recovery_count block operations per frame,
+ * payloads are at most 65522 bytes so that a block stays within 65535 bytes
+ */
+CM256_CODEC_CXX_API(bool)
+cm256_wide_encode(
+    uint16_t & frame_index, 
+    uint8_t & frame_filter, 
+    std::list<std::vector<uint8_t>> & dst_data_list, 
+    const std::list<std::vector<uint8_t>> & src_data_list, 
+    double recovery_rate, 
+    std::size_t max_data_size = 0, 
+    bool recovery_force = false, 
+    std::size_t max_original_count = 0, 
+    std::size_t max_frame_bytes = 0
+);
+
+CM256_CODEC_CXX_API(bool)
+cm256_wide_decode(
+    const void * data, 
+    std::size_t data_len, 
+    wide_frames_t & frames, 
+    std::list<std::vector<uint8_t>> & dst_data_list, 
+    uint32_t max_delay_microseconds = 1000 * 15, 
+    bool recovery_force = false
+);
+
+
+#endif // CM256_WIDE_H
@@ -0,0 +1,69 @@
+/********************************************************
+ * Description : cm256 sliding window codec
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#ifndef CM256_WINDOW_H
+#define CM256_WINDOW_H
+
+
+#include "cm256_codec.h"
+
+struct CM256_CODEC_TYPE window_encoder_t
+{
+    uint16_t                            sequence;
+    uint16_t                            repair_sequence;
+    double                              repair_credit;
+    std::list<std::vector<uint8_t>>     source_list;
+
+    window_encoder_t();
+};
+
+struct window_row_t
+{
+    uint32_t                            begin;
+    std::vector<uint8_t>                coefficient;
+    std::vector<uint8_t>                symbol;
+};
+
+struct CM256_CODEC_TYPE window_decoder_t
+{
+    bool                                started;
+    uint32_t                            sequence;
+    std::map<uint32_t, std::vector<uint8_t>>    source_map;
+    std::map<uint32_t, window_row_t>            row_map;
+
+    window_decoder_t();
+};
+
+/*
+ * sliding window (convolutional) codec: every source packet is sent as is, and after each one
+ * repair packets are emitted at recovery_rate, each covering the last window_size source packets,
+ * the decoder solves repairs incrementally and delivers a lost packet as soon as it is determined,
+ * so repair latency is bounded by the window rather than by a frame
+ */
+CM256_CODEC_CXX_API(bool)
+cm256_window_encode(
+    const void * data, 
+    std::size_t data_len, 
+    window_encoder_t & encoder, 
+    std::list<std::vector<uint8_t>> & dst_data_list, 
+    double recovery_rate, 
+    std::size_t window_size = 16
+);
+
+CM256_CODEC_CXX_API(bool)
+cm256_window_decode(
+    const void * data, 
+    std::size_t data_len, 
+    window_decoder_t & decoder, 
+    std::list<std::vector<uint8_t>> & dst_data_list, 
+    std::size_t window_size = 16
+);
+
+
+#endif // CM256_WINDOW_H
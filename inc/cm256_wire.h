@@ -0,0 +1,72 @@
+/********************************************************
+ * Description : cm256 wire format
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#ifndef CM256_WIRE_H
+#define CM256_WIRE_H
+
+
+#include "cm256_codec.h"
+
+/*
+ * what both ends of a stream agreed on, version 1 is the block layout the encoders produce,
+ * version 2 is the compact one below, block_bytes and the counts describe a full frame of the
+ * stream, so its originals go without counts or padding (0 leaves them on every block),
+ * with checksum every block of either version ends in a big endian crc32c of the bytes before it,
+ * and a block that fails it is rejected before it reaches a frame
+ *
+ * version 2 block:
+ *   byte 0      version in the high nibble, WIRE_FLAG_* in the low nibble
+ *   bytes 1..3  frame sequence, big endian, frame_filter is its high byte
+ *   byte 4      block_index
+ *   bytes 5..6  original_count, recovery_count, only with WIRE_FLAG_COUNTS
+ *   the rest    with WIRE_FLAG_BODY the version 1 body (length and padded chunk), else the bare payload
+ */
+struct CM256_CODEC_TYPE wire_format_t
+{
+    uint8_t                             version;
+    uint16_t                            block_bytes;
+    uint8_t                             original_count;
+    uint8_t                             recovery_count;
+    bool                                checksum;
+
+    wire_format_t();
+};
+
+/* rewrites blocks from cm256_encode / cm256_stream_encode into the format, version 1 without checksum leaves them alone */
+CM256_CODEC_CXX_API(bool)
+cm256_wire_pack(
+    const wire_format_t & format, 
+    std::list<std::vector<uint8_t>> & data_list
+);
+
+/* checks the crc32c trailer of a block packed with checksum */
+CM256_CODEC_CXX_API(bool)
+cm256_wire_verify(
+    const void * data, 
+    std::size_t data_len
+);
+
+/* turns a block in the format back into the version 1 layout the decoders take, false for a malformed or corrupted block */
+CM256_CODEC_CXX_API(bool)
+cm256_wire_unpack(
+    const wire_format_t & format, 
+    const void * data, 
+    std::size_t data_len, 
+    std::vector<uint8_t> & block
+);
+
+/* the decoder session unpacks every block it is given from this format, each peer of a mixed fleet gets its own */
+CM256_CODEC_CXX_API(bool)
+cm256_decoder_set_wire_format(
+    cm256_decoder_t * decoder, 
+    const wire_format_t & format
+);
+
+
+#endif // CM256_WIRE_H
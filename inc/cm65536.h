@@ -0,0 +1,86 @@
+/********************************************************
+ * Description : Cauchy MDS GF(2^16) wide codec
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#ifndef CM65536_H
+#define CM65536_H
+
+#include "gf65536.h"
+
+class CM65536
+{
+public:
+    // Encoder parameters
+    typedef struct cm65536_encoder_params_t {
+        // Original block count < 65536
+        int OriginalCount;
+
+        // Recovery block count < 65536
+        int RecoveryCount;
+
+        // Number of bytes per block (all blocks are the same size in bytes, must be even)
+        int BlockBytes;
+    } cm65536_encoder_params;
+
+    // Descriptor for data block
+    typedef struct cm65536_block_t {
+        // Pointer to data received.
+        void* Block;
+
+        // Block index, same convention as CM256::cm256_block:
+        // originals in [0..(originalCount-1)], recovery blocks in
+        // [originalCount..(originalCount+recoveryCount-1)].
+        uint16_t Index;
+    } cm65536_block;
+
+    CM65536();
+    ~CM65536();
+
+    bool isInitialized() const { return m_initialized; };
+
+    /*
+     * Cauchy MDS GF(2^16) encode
+     *
+     * Same contract as CM256::cm256_encode(), with the matrix built over
+     * GF(2^16) so that a frame may hold up to 65536 blocks in total.
+     *
+     * Precondition: originalCount + recoveryCount <= 65536, blockBytes even
+     *
+     * Returns 0 on success, and any other code indicates failure.
+     */
+    int cm65536_encode(
+        cm65536_encoder_params params, // Encoder parameters
+        cm65536_block* originals,      // Array of pointers to original blocks
+        uint8_t ** recoveryBlocks);    // Output recovery blocks array
+
+    /*
+     * Cauchy MDS GF(2^16) decode
+     *
+     * Same contract as CM256::cm256_decode(): 'blocks' holds 'originalCount'
+     * received blocks, recovery blocks are replaced with the original data
+     * they recover and their Index is updated accordingly.
+     *
+     * The erased part of the Cauchy matrix is inverted in closed form, so the
+     * matrix work is quadratic in the number of erasures.
+     *
+     * Returns 0 on success, and any other code indicates failure.
+     */
+    int cm65536_decode(
+        cm65536_encoder_params params, // Encoder parameters
+        cm65536_block* blocks);        // Array of 'originalCount' blocks as described above
+
+private:
+    // Matrix element for recovery row x_i and original column y_j
+    uint16_t getMatrixElement(uint16_t x_i, uint16_t x_0, uint16_t y_j);
+
+    gf65536_ctx m_gf65536Ctx;
+    bool m_initialized;
+};
+
+
+#endif // CM65536_H
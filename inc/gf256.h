@@ -32,8 +32,8 @@
 #include <stdint.h> // uint32_t etc
 #include <string.h> // memcpy, memset
 
-// TBD: Fix the polynomial at one value and use precomputed tables here to
-// simplify the API for GF256.h version 2.  Avoids user data alignment issues.
+// The polynomial is fixed and the tables are precomputed by
+// tools/gf256_tables_gen.cpp into src/gf256_tables.cpp.
 
 
 //-----------------------------------------------------------------------------
@@ -113,25 +113,21 @@
 //-----------------------------------------------------------------------------
 // GF(256) Context
 //
-// The context object stores tables required to perform library calculations.
+// The context object gives access to the tables required to perform library
+// calculations.
 //
 // Usage Notes:
-// This struct should be aligned in memory, meaning that a pointer to it should
-// have the low 4 bits cleared.  To achieve this simply tag the gf256_ctx object
-// with the GF256_ALIGNED macro provided above.
+// The tables are static const data generated at build time, so a context
+// holds no state, needs no initialization and may be shared by any number
+// of threads; the tables live in read-only pages shared between processes.
 
-#ifdef _MSC_VER
-    #pragma warning(push)
-    #pragma warning(disable: 4324) // warning C4324: 'gf256_ctx' : structure was padded due to __declspec(align())
-#endif
-
-class gf256_ctx // 141,072 bytes
+class gf256_ctx
 {
 public:
     gf256_ctx();
     ~gf256_ctx();
 
-    bool isInitialized() const { return initialized; }
+    bool isInitialized() const { return true; }
 
     /** Performs "x[] += y[]" bulk memory XOR operation */
     static void gf256_add_mem(void * GF256_RESTRICT vx, const void * GF256_RESTRICT vy, int bytes);
@@ -187,55 +183,24 @@ public:
         gf256_mul_mem(vz, vx, GF256_INV_TABLE[y], bytes); // Multiply by inverse
     }
 
-    // Polynomial used
-    unsigned Polynomial;
+    // Polynomial used: 0xa6, the 4th of the 16 irreducible polynomials for GF(256)
+    static const unsigned Polynomial = (0xa6 << 1) | 1;
 
     // Log/Exp tables
-    uint16_t GF256_LOG_TABLE[256];
-    uint8_t GF256_EXP_TABLE[512 * 2 + 1];
+    static const uint16_t GF256_LOG_TABLE[256];
+    static const uint8_t GF256_EXP_TABLE[512 * 2 + 1];
 
     // Mul/Div/Inv tables
-    uint8_t GF256_MUL_TABLE[256 * 256];
-    uint8_t GF256_DIV_TABLE[256 * 256];
-    uint8_t GF256_INV_TABLE[256];
+    static const uint8_t GF256_MUL_TABLE[256 * 256];
+    static const uint8_t GF256_DIV_TABLE[256 * 256];
+    static const uint8_t GF256_INV_TABLE[256];
 
-    // Muladd_mem tables
+    // Muladd_mem tables, one 16 byte row per y
     // We require memory to be aligned since the SIMD instructions benefit from
     // aligned accesses to the MM256_* table data.
-    GF256_ALIGNED GF256_M128 MM256_TABLE_LO_Y[256];
-    GF256_ALIGNED GF256_M128 MM256_TABLE_HI_Y[256];
-
-private:
-    int gf256_init_();
-
-    void gf255_poly_init(int polynomialIndex); //!< Select which polynomial to use
-    void gf256_explog_init();                  //!< Construct EXP and LOG tables from polynomial
-    void gf256_muldiv_init();                  //!< Initialize MUL and DIV tables using LOG and EXP tables
-    void gf256_inv_init();                     //!< Initialize INV table using DIV table
-    void gf256_muladd_mem_init();              //!< Initialize the MM256 tables using gf256_mul()
-
-    static bool IsLittleEndian()
-    {
-        int x = 1;
-        char *y = (char *) &x;
-
-        return *y != 0;
-    }
-
-    //-----------------------------------------------------------------------------
-    // Generator Polynomial
-
-    // There are only 16 irreducible polynomials for GF(256)
-    static const int GF256_GEN_POLY_COUNT = 16;
-    static const uint8_t GF256_GEN_POLY[GF256_GEN_POLY_COUNT];
-    static const int DefaultPolynomialIndex = 3;
-
-    bool initialized;
+    GF256_ALIGNED static const uint8_t MM256_TABLE_LO_Y[256][16];
+    GF256_ALIGNED static const uint8_t MM256_TABLE_HI_Y[256][16];
 };
 
-#ifdef _MSC_VER
-    #pragma warning(pop)
-#endif
-
 
 #endif // GF256_H
@@ -0,0 +1,85 @@
+/********************************************************
+ * Description : GF(2^16) arithmetic for the wide codec
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#ifndef GF65536_H
+#define GF65536_H
+
+#include "gf256.h" // platform definitions and gf256_add_mem
+
+//-----------------------------------------------------------------------------
+// GF(2^16) Context
+//
+// Symbols are 16-bit little-endian words, so every bulk memory operation
+// requires an even number of bytes.  Multiplication by a constant uses the
+// same split-table technique as gf256_ctx, with the 16-bit product of each of
+// the four nibbles of a symbol looked up as a low byte and a high byte.
+
+class gf65536_ctx // 393,220 bytes
+{
+public:
+    gf65536_ctx();
+    ~gf65536_ctx();
+
+    bool isInitialized() const { return initialized; }
+
+    // return x + y
+    static GF256_FORCE_INLINE uint16_t gf65536_add(const uint16_t x, const uint16_t y)
+    {
+        return x ^ y;
+    }
+
+    // return x * y
+    GF256_FORCE_INLINE uint16_t gf65536_mul(uint16_t x, uint16_t y)
+    {
+        if (x == 0 || y == 0)
+        {
+            return 0;
+        }
+        return GF65536_EXP_TABLE[GF65536_LOG_TABLE[x] + GF65536_LOG_TABLE[y]];
+    }
+
+    // return x / y, y must be non-zero
+    GF256_FORCE_INLINE uint16_t gf65536_div(uint16_t x, uint16_t y)
+    {
+        if (x == 0)
+        {
+            return 0;
+        }
+        return GF65536_EXP_TABLE[GF65536_LOG_TABLE[x] + 65535 - GF65536_LOG_TABLE[y]];
+    }
+
+    // return 1 / x, x must be non-zero
+    GF256_FORCE_INLINE uint16_t gf65536_inv(uint16_t x)
+    {
+        return GF65536_EXP_TABLE[65535 - GF65536_LOG_TABLE[x]];
+    }
+
+    /** Performs "z[] = x[] * y" bulk memory operation, bytes must be even */
+    void gf65536_mul_mem(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx, uint16_t y, int bytes);
+    /** Performs "z[] += x[] * y" bulk memory operation, bytes must be even */
+    void gf65536_muladd_mem(void * GF256_RESTRICT vz, uint16_t y, const void * GF256_RESTRICT vx, int bytes);
+
+    // Polynomial used
+    unsigned Polynomial;
+
+    // Log/Exp tables, the exp table is doubled to skip the modulo in mul/div
+    uint16_t GF65536_LOG_TABLE[65536];
+    uint16_t GF65536_EXP_TABLE[65535 * 2];
+
+private:
+    int gf65536_init_();
+
+    //!< Build the eight 16-entry partial product tables for constant y
+    void gf65536_mul_tables(uint16_t y, GF256_M128 * tables);
+
+    bool initialized;
+};
+
+
+#endif // GF65536_H
@@ -118,31 +118,79 @@ CM256::~CM256()
 //-----------------------------------------------------------------------------
 // Encoding
 
+// Length of the part of an original that may be non-zero.
+static inline int GetOriginalBytes(const CM256::cm256_encoder_params& params, const int* originalBytes, int j)
+{
+    return originalBytes ? originalBytes[j] : params.BlockBytes;
+}
+
+// Every prefix length must fit in the block.
+static bool CheckOriginalBytes(const CM256::cm256_encoder_params& params, const int* originalBytes, int count)
+{
+    for (int j = 0; j < count; ++j)
+    {
+        if (originalBytes[j] < 0 || originalBytes[j] > params.BlockBytes)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 void CM256::cm256_encode_block(
     cm256_encoder_params params, // Encoder parameters
     cm256_block* originals,      // Array of pointers to original blocks
     int recoveryBlockIndex,      // Return value from cm256_get_recovery_block_index()
-    void* recoveryBlock)         // Output recovery block
+    void* recoveryBlock,         // Output recovery block
+    const int* originalBytes)    // Non-zero prefix lengths, nullptr for full blocks
 {
+    uint8_t* recoveryData = static_cast<uint8_t*>(recoveryBlock);
+
     // If only one block of input data,
     if (params.OriginalCount == 1)
     {
         // No meaningful operation here, degenerate to outputting the same data each time.
+        const int bytes = GetOriginalBytes(params, originalBytes, 0);
 
-        memcpy(recoveryBlock, originals[0].Block, params.BlockBytes);
+        memcpy(recoveryData, originals[0].Block, bytes);
+        memset(recoveryData + bytes, 0, params.BlockBytes - bytes);
         return;
     }
     // else OriginalCount >= 2:
 
+    // Start from the longest original, its product sets every byte that can be
+    // non-zero, so the rest of the recovery block is cleared once and the other
+    // originals are only added over their own prefix.
+    int first = 0;
+    if (originalBytes)
+    {
+        for (int j = 1; j < params.OriginalCount; ++j)
+        {
+            if (originalBytes[j] > originalBytes[first])
+            {
+                first = j;
+            }
+        }
+    }
+    const int firstBytes = GetOriginalBytes(params, originalBytes, first);
+    memset(recoveryData + firstBytes, 0, params.BlockBytes - firstBytes);
+
     // Unroll first row of recovery matrix:
     // The matrix we generate for the first row is all ones,
     // so it is merely a parity of the original data.
     if (recoveryBlockIndex == params.OriginalCount)
     {
-        gf256_ctx::gf256_addset_mem(recoveryBlock, originals[0].Block, originals[1].Block, params.BlockBytes);
-        for (int j = 2; j < params.OriginalCount; ++j)
+        const int second = (first == 0) ? 1 : 0;
+        const int secondBytes = GetOriginalBytes(params, originalBytes, second);
+
+        gf256_ctx::gf256_addset_mem(recoveryData, originals[first].Block, originals[second].Block, secondBytes);
+        memcpy(recoveryData + secondBytes, static_cast<const uint8_t*>(originals[first].Block) + secondBytes, firstBytes - secondBytes);
+        for (int j = 0; j < params.OriginalCount; ++j)
         {
-            gf256_ctx::gf256_add_mem(recoveryBlock, originals[j].Block, params.BlockBytes);
+            if (j != first && j != second)
+            {
+                gf256_ctx::gf256_add_mem(recoveryData, originals[j].Block, GetOriginalBytes(params, originalBytes, j));
+            }
         }
         return;
     }
@@ -158,19 +206,24 @@ void CM256::cm256_encode_block(
 
         // Unroll first operation for speed
         {
-            const uint8_t y_0 = 0;
-            const uint8_t matrixElement = m_gf256Ctx.getMatrixElement(x_i, x_0, y_0);
+            const uint8_t y_first = static_cast<uint8_t>(first);
+            const uint8_t matrixElement = m_gf256Ctx.getMatrixElement(x_i, x_0, y_first);
 
-            m_gf256Ctx.gf256_mul_mem(recoveryBlock, originals[0].Block, matrixElement, params.BlockBytes);
+            m_gf256Ctx.gf256_mul_mem(recoveryData, originals[first].Block, matrixElement, firstBytes);
         }
 
         // For each original data column,
-        for (int j = 1; j < params.OriginalCount; ++j)
+        for (int j = 0; j < params.OriginalCount; ++j)
         {
+            if (j == first)
+            {
+                continue;
+            }
+
             const uint8_t y_j = static_cast<uint8_t>(j);
             const uint8_t matrixElement = m_gf256Ctx.getMatrixElement(x_i, x_0, y_j);
 
-            m_gf256Ctx.gf256_muladd_mem(recoveryBlock, matrixElement, originals[j].Block, params.BlockBytes);
+            m_gf256Ctx.gf256_muladd_mem(recoveryData, matrixElement, originals[j].Block, GetOriginalBytes(params, originalBytes, j));
         }
     }
 }
@@ -200,7 +253,7 @@ int CM256::cm256_encode(
 
     for (int block = 0; block < params.RecoveryCount; ++block, recoveryBlock += params.BlockBytes)
     {
-        cm256_encode_block(params, originals, (params.OriginalCount + block), recoveryBlock);
+        cm256_encode_block(params, originals, (params.OriginalCount + block), recoveryBlock, nullptr);
     }
 
     return 0;
@@ -210,6 +263,15 @@ int CM256::cm256_encode(
     cm256_encoder_params params, // Encoder parameters
     cm256_block* originals,      // Array of pointers to original blocks
     uint8_t ** recoveryBlocks)   // Output recovery blocks array size
+{
+    return cm256_encode(params, originals, recoveryBlocks, nullptr);
+}
+
+int CM256::cm256_encode(
+    cm256_encoder_params params, // Encoder parameters
+    cm256_block* originals,      // Array of pointers to original blocks
+    uint8_t ** recoveryBlocks,   // Output recovery blocks array
+    const int* originalBytes)    // Non-zero prefix length of each original
 {
     // Validate input:
     if (params.OriginalCount <= 0 ||
@@ -226,10 +288,82 @@ int CM256::cm256_encode(
     {
         return -3;
     }
+    if (originalBytes && !CheckOriginalBytes(params, originalBytes, params.OriginalCount))
+    {
+        return -4;
+    }
 
     for (int block = 0; block < params.RecoveryCount; ++block)
     {
-        cm256_encode_block(params, originals, (params.OriginalCount + block), recoveryBlocks[block]);
+        cm256_encode_block(params, originals, (params.OriginalCount + block), recoveryBlocks[block], originalBytes);
+    }
+
+    return 0;
+}
+
+int CM256::cm256_encode_accumulate(
+    cm256_encoder_params params, // Encoder parameters
+    const cm256_block& original, // Original block, Index in [0..(originalCount-1)]
+    uint8_t ** recoveryBlocks)   // Output recovery blocks array
+{
+    return cm256_encode_accumulate(params, original, recoveryBlocks, params.BlockBytes);
+}
+
+int CM256::cm256_encode_accumulate(
+    cm256_encoder_params params, // Encoder parameters
+    const cm256_block& original, // Original block, Index in [0..(originalCount-1)]
+    uint8_t ** recoveryBlocks,   // Output recovery blocks array
+    int originalBytes)           // Non-zero prefix length of the original
+{
+    // Validate input:
+    if (params.OriginalCount <= 0 ||
+        params.RecoveryCount <= 0 ||
+        params.BlockBytes <= 0)
+    {
+        return -1;
+    }
+    if (params.OriginalCount + params.RecoveryCount > 256)
+    {
+        return -2;
+    }
+    if (!original.Block || !recoveryBlocks)
+    {
+        return -3;
+    }
+    if (original.Index >= params.OriginalCount)
+    {
+        return -4;
+    }
+    if (originalBytes < 0 || originalBytes > params.BlockBytes)
+    {
+        return -4;
+    }
+
+    // If only one block of input data, every recovery block is a copy of it.
+    // The recovery blocks start zero-filled, so the tail needs no clearing.
+    if (params.OriginalCount == 1)
+    {
+        for (int block = 0; block < params.RecoveryCount; ++block)
+        {
+            memcpy(recoveryBlocks[block], original.Block, originalBytes);
+        }
+        return 0;
+    }
+
+    // First row of recovery matrix is all ones: parity of the original data.
+    gf256_ctx::gf256_add_mem(recoveryBlocks[0], original.Block, originalBytes);
+
+    // Start the x_0 values arbitrarily from the original count.
+    const uint8_t x_0 = static_cast<uint8_t>(params.OriginalCount);
+    const uint8_t y_j = original.Index;
+
+    // For other rows, add this original's column of the matrix.
+    for (int block = 1; block < params.RecoveryCount; ++block)
+    {
+        const uint8_t x_i = static_cast<uint8_t>(params.OriginalCount + block);
+        const uint8_t matrixElement = m_gf256Ctx.getMatrixElement(x_i, x_0, y_j);
+
+        m_gf256Ctx.gf256_muladd_mem(recoveryBlocks[block], matrixElement, original.Block, originalBytes);
     }
 
     return 0;
@@ -250,7 +384,7 @@ CM256::CM256Decoder::~CM256Decoder()
 {
 }
 
-bool CM256::CM256Decoder::Initialize(cm256_encoder_params& params, cm256_block* blocks)
+bool CM256::CM256Decoder::Initialize(cm256_encoder_params& params, cm256_block* blocks, const int* blockBytes)
 {
     Params = params;
 
@@ -272,6 +406,13 @@ bool CM256::CM256Decoder::Initialize(cm256_encoder_params& params, cm256_block*
         // If it is an original block,
         if (row < params.OriginalCount)
         {
+            const int bytes = blockBytes ? blockBytes[ii] : params.BlockBytes;
+            if (bytes < 0 || bytes > params.BlockBytes)
+            {
+                return false;
+            }
+
+            OriginalBytes[OriginalCount] = bytes;
             Original[OriginalCount++] = block;
 
             if (ErasuresIndices[row] != 0)
@@ -310,20 +451,32 @@ void CM256::CM256Decoder::DecodeM1()
     // XOR all other blocks into the recovery block
     uint8_t* outBlock = static_cast<uint8_t*>(Recovery[0]->Block);
     const uint8_t* inBlock = nullptr;
+    int inBytes = 0;
 
     // For each block,
     for (int ii = 0; ii < OriginalCount; ++ii)
     {
         const uint8_t* inBlock2 = static_cast<const uint8_t*>(Original[ii]->Block);
+        const int inBytes2 = OriginalBytes[ii];
 
         if (!inBlock)
         {
             inBlock = inBlock2;
+            inBytes = inBytes2;
         }
         else
         {
-            // outBlock ^= inBlock ^ inBlock2
-            gf256_ctx::gf256_add2_mem(outBlock, inBlock, inBlock2, Params.BlockBytes);
+            // outBlock ^= inBlock ^ inBlock2 over the common prefix, then the longer tail
+            const int commonBytes = (inBytes < inBytes2) ? inBytes : inBytes2;
+            gf256_ctx::gf256_add2_mem(outBlock, inBlock, inBlock2, commonBytes);
+            if (inBytes > commonBytes)
+            {
+                gf256_ctx::gf256_add_mem(outBlock + commonBytes, inBlock + commonBytes, inBytes - commonBytes);
+            }
+            else if (inBytes2 > commonBytes)
+            {
+                gf256_ctx::gf256_add_mem(outBlock + commonBytes, inBlock2 + commonBytes, inBytes2 - commonBytes);
+            }
             inBlock = nullptr;
         }
     }
@@ -331,7 +484,7 @@ void CM256::CM256Decoder::DecodeM1()
     // Complete XORs
     if (inBlock)
     {
-        gf256_ctx::gf256_add_mem(outBlock, inBlock, Params.BlockBytes);
+        gf256_ctx::gf256_add_mem(outBlock, inBlock, inBytes);
     }
 
     // Recover the index it corresponds to
@@ -460,6 +613,7 @@ void CM256::CM256Decoder::Decode()
     for (int originalIndex = 0; originalIndex < OriginalCount; ++originalIndex)
     {
         const uint8_t* inBlock = static_cast<const uint8_t*>(Original[originalIndex]->Block);
+        const int inBytes = OriginalBytes[originalIndex];
         const uint8_t inRow = Original[originalIndex]->Index;
 
         for (int recoveryIndex = 0; recoveryIndex < N; ++recoveryIndex)
@@ -469,7 +623,7 @@ void CM256::CM256Decoder::Decode()
             const uint8_t y_j = inRow;
             const uint8_t matrixElement = m_gf256Ctx.getMatrixElement(x_i, x_0, y_j);
 
-            m_gf256Ctx.gf256_muladd_mem(outBlock, matrixElement, inBlock, Params.BlockBytes);
+            m_gf256Ctx.gf256_muladd_mem(outBlock, matrixElement, inBlock, inBytes);
         }
     }
 
@@ -551,6 +705,14 @@ void CM256::CM256Decoder::Decode()
 int CM256::cm256_decode(
     cm256_encoder_params params, // Encoder params
     cm256_block* blocks)         // Array of 'originalCount' blocks as described above
+{
+    return cm256_decode(params, blocks, nullptr);
+}
+
+int CM256::cm256_decode(
+    cm256_encoder_params params, // Encoder params
+    cm256_block* blocks,         // Array of 'originalCount' blocks as described above
+    const int* blockBytes)       // Non-zero prefix length of each original in 'blocks'
 {
     if (params.OriginalCount <= 0 ||
         params.RecoveryCount <= 0 ||
@@ -576,7 +738,7 @@ int CM256::cm256_decode(
     }
 
     CM256Decoder state(m_gf256Ctx);
-    if (!state.Initialize(params, blocks))
+    if (!state.Initialize(params, blocks, blockBytes))
     {
         return -5;
     }
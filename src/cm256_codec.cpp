@@ -15,10 +15,15 @@
 #endif // _MSC_VER
 
 #include <ctime>
+#include <chrono>
 #include <cstring>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "cm256.h"
 #include "cm256_codec.h"
+#include "cm256_wire.h"
 
 #pragma pack(push, 1)
 
@@ -45,6 +50,31 @@ struct block_t
 
 #pragma pack(pop)
 
+struct order_frame_t
+{
+    std::list<std::vector<uint8_t>>     data_list;
+    uint32_t                            release_seconds;
+    uint32_t                            release_microseconds;
+};
+
+struct cm256_decoder_t
+{
+    frames_t                            frames;
+    uint32_t                            max_delay_microseconds;
+    std::size_t                         max_frame_count;
+    std::size_t                         max_buffer_bytes;
+    std::size_t                         buffer_bytes;
+    bool                                in_order;
+    std::size_t                         max_hold_frames;
+    uint32_t                            max_hold_microseconds;
+    bool                                order_started;
+    uint64_t                            order_sequence;
+    std::map<uint64_t, order_frame_t>   order_map;
+    wire_format_t                       wire_format;
+    std::vector<uint8_t>                wire_block;
+    bool                                wire_checksum;
+};
+
 frame_header_t::frame_header_t()
     : frame_index(0)
     , frame_filter(0)
@@ -57,8 +87,79 @@ frame_header_t::frame_header_t()
     memset(block_bitmap, 0x0, sizeof(block_bitmap));
 }
 
+stream_encoder_t::stream_encoder_t()
+    : frame_index(0)
+    , frame_filter(0)
+    , original_count(0)
+    , recovery_count(0)
+    , block_bytes(0)
+    , recovery_rate(0.0)
+    , recovery_force(false)
+    , flush_seconds(0)
+    , flush_microseconds(0)
+    , original_list()
+    , recovery_list()
+{
+}
+
+static CM256 & get_cm256()
+{
+    static CM256 s_cm256;
+    return s_cm256;
+}
+
+static cm256_clock_t s_clock = nullptr;
+
+#ifdef CM256_CODEC_PROFILE
+
+struct encode_counters_t
+{
+    stats_counter_t                     original_bytes;
+    stats_histogram_counter_t           original_nanoseconds;
+    stats_histogram_counter_t           recovery_nanoseconds;
+    stats_histogram_counter_t           cm256_nanoseconds;
+    stats_histogram_counter_t           splice_nanoseconds;
+};
+
+static encode_counters_t s_encode_counters;
+
+class profile_probe_t
+{
+public:
+    explicit profile_probe_t(stats_histogram_counter_t & histogram)
+        : m_histogram(histogram)
+        , m_begin(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~profile_probe_t()
+    {
+        m_histogram.add_shared(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_begin).count()));
+    }
+
+private:
+    stats_histogram_counter_t         & m_histogram;
+    std::chrono::steady_clock::time_point m_begin;
+};
+
+#define CM256_CODEC_PROFILE_SCOPE(name) profile_probe_t profile_probe_##name(s_encode_counters.name)
+#define CM256_CODEC_PROFILE_BYTES(bytes) s_encode_counters.original_bytes.add_shared(bytes)
+
+#else
+
+#define CM256_CODEC_PROFILE_SCOPE(name)
+#define CM256_CODEC_PROFILE_BYTES(bytes)
+
+#endif // CM256_CODEC_PROFILE
+
 static void get_current_time(uint32_t & seconds, uint32_t & microseconds)
 {
+    if (nullptr != s_clock)
+    {
+        s_clock(seconds, microseconds);
+        return;
+    }
+
 #ifdef _MSC_VER
     SYSTEMTIME sys_now = { 0x0 };
     GetLocalTime(&sys_now);
@@ -72,8 +173,20 @@ static void get_current_time(uint32_t & seconds, uint32_t & microseconds)
 #endif // _MSC_VER
 }
 
+void cm256_set_clock(cm256_clock_t clock)
+{
+    s_clock = clock;
+}
+
+void cm256_get_time(uint32_t & seconds, uint32_t & microseconds)
+{
+    get_current_time(seconds, microseconds);
+}
+
 static bool create_original_blocks(CM256::cm256_block * blocks, std::list<std::vector<uint8_t>> & original_blocks, uint16_t frame_index, uint8_t frame_filter, uint8_t original_count, uint8_t recovery_count, uint16_t block_bytes, std::list<std::vector<uint8_t>>::const_iterator & iter)
 {
+    CM256_CODEC_PROFILE_SCOPE(original_nanoseconds);
+
     const uint16_t block_size = static_cast<uint16_t>(sizeof(block_header_t) + sizeof(uint16_t) + block_bytes);
 
     frame_index = htons(frame_index);
@@ -86,6 +199,8 @@ static bool create_original_blocks(CM256::cm256_block * blocks, std::list<std::v
             return false;
         }
 
+        CM256_CODEC_PROFILE_BYTES(data.size());
+
         std::vector<uint8_t> original_buffer(block_size, 0x0);
 
         block_t * block = reinterpret_cast<block_t *>(&original_buffer[0]);
@@ -109,6 +224,13 @@ static bool create_original_blocks(CM256::cm256_block * blocks, std::list<std::v
     return true;
 }
 
+/* the length prefix plus the payload, the rest of the block is zero padding the GF kernels can skip */
+static int get_original_bytes(const block_body_t * body, int block_bytes)
+{
+    const int original_bytes = static_cast<int>(sizeof(uint16_t) + ntohs(body->block_bytes));
+    return (original_bytes < block_bytes ? original_bytes : block_bytes);
+}
+
 static bool create_recovery_blocks(CM256::cm256_block * blocks, std::list<std::vector<uint8_t>> & recovery_blocks, uint16_t frame_index, uint8_t frame_filter, uint8_t original_count, uint8_t recovery_count, uint16_t block_bytes)
 {
     if (0 == recovery_count)
@@ -116,6 +238,8 @@ static bool create_recovery_blocks(CM256::cm256_block * blocks, std::list<std::v
         return true;
     }
 
+    CM256_CODEC_PROFILE_SCOPE(recovery_nanoseconds);
+
     uint8_t * recovery_data[256] = { 0x0 };
 
     const uint16_t block_size = static_cast<uint16_t>(sizeof(block_header_t) + sizeof(uint16_t) + block_bytes);
@@ -141,22 +265,74 @@ static bool create_recovery_blocks(CM256::cm256_block * blocks, std::list<std::v
         recovery_blocks.emplace_back(std::move(recovery_buffer));
     }
 
-    CM256 cm256;
+    CM256 & cm256 = get_cm256();
     if (!cm256.isInitialized())
     {
         return false;
     }
 
     CM256::cm256_encoder_params params = { original_count, recovery_count, static_cast<int>(sizeof(uint16_t) + block_bytes) };
-    if (0 != cm256.cm256_encode(params, blocks, recovery_data))
+
+    int original_bytes[256] = { 0x0 };
+    for (uint8_t block_index = 0; block_index < original_count; ++block_index)
     {
-        return false;
+        original_bytes[block_index] = get_original_bytes(reinterpret_cast<const block_body_t *>(blocks[block_index].Block), params.BlockBytes);
+    }
+
+    {
+        CM256_CODEC_PROFILE_SCOPE(cm256_nanoseconds);
+        if (0 != cm256.cm256_encode(params, blocks, recovery_data, original_bytes))
+        {
+            return false;
+        }
     }
 
     return true;
 }
 
-bool cm256_encode(uint16_t & frame_index, uint8_t & frame_filter, std::list<std::vector<uint8_t>> & dst_data_list, const std::list<std::vector<uint8_t>> & src_data_list, double recovery_rate, std::size_t max_data_size, bool recovery_force)
+static uint8_t get_recovery_count(uint8_t original_count, double recovery_rate)
+{
+    if (static_cast<uint8_t>(255.0 * (1.0 - recovery_rate) + 0.5) == original_count)
+    {
+        return static_cast<uint8_t>(255 - original_count);
+    }
+
+    std::size_t recovery_count = static_cast<std::size_t>(static_cast<double>(original_count) * recovery_rate / (1.0 - recovery_rate) + 0.5);
+    if (recovery_count > static_cast<std::size_t>(255 - original_count))
+    {
+        recovery_count = static_cast<std::size_t>(255 - original_count);
+    }
+    return static_cast<uint8_t>(recovery_count);
+}
+
+static uint8_t get_original_count(double recovery_rate, uint16_t block_bytes, std::size_t max_original_count, std::size_t max_frame_bytes)
+{
+    std::size_t original_count = static_cast<std::size_t>(255.0 * (1.0 - recovery_rate) + 0.5);
+
+    if (0 != max_original_count && original_count > max_original_count)
+    {
+        original_count = max_original_count;
+    }
+
+    if (0 != max_frame_bytes)
+    {
+        const std::size_t block_size = sizeof(block_header_t) + sizeof(uint16_t) + block_bytes;
+        const std::size_t frame_original_count = (max_frame_bytes > block_size ? max_frame_bytes / block_size : 1);
+        if (original_count > frame_original_count)
+        {
+            original_count = frame_original_count;
+        }
+    }
+
+    if (0 == original_count)
+    {
+        original_count = 1;
+    }
+
+    return static_cast<uint8_t>(original_count);
+}
+
+bool cm256_encode(uint16_t & frame_index, uint8_t & frame_filter, std::list<std::vector<uint8_t>> & dst_data_list, const std::list<std::vector<uint8_t>> & src_data_list, double recovery_rate, std::size_t max_data_size, bool recovery_force, std::size_t max_original_count, std::size_t max_frame_bytes)
 {
     if (recovery_rate < 0.0 || recovery_rate >= 1.0)
     {
@@ -182,22 +358,15 @@ bool cm256_encode(uint16_t & frame_index, uint8_t & frame_filter, std::list<std:
     std::list<std::vector<uint8_t>>::const_iterator iter = src_data_list.begin();
 
     uint16_t block_bytes = static_cast<uint16_t>(max_data_size);
-    uint8_t original_count = static_cast<uint8_t>(255.0 * (1.0 - recovery_rate) + 0.5);
-    uint8_t recovery_count = static_cast<uint8_t>(255 - original_count);
+    uint8_t original_count = get_original_count(recovery_rate, block_bytes, max_original_count, max_frame_bytes);
+    uint8_t recovery_count = get_recovery_count(original_count, recovery_rate);
 
     while (0 != data_list_left)
     {
         if (original_count > data_list_left)
         {
             original_count = static_cast<uint8_t>(data_list_left);
-            if (recovery_rate >= 1.0)
-            {
-                recovery_count = static_cast<uint8_t>(255 - data_list_left);
-            }
-            else
-            {
-                recovery_count = static_cast<uint8_t>(static_cast<double>(data_list_left) * recovery_rate / (1.0 - recovery_rate) + 0.5);
-            }
+            recovery_count = get_recovery_count(original_count, recovery_rate);
         }
         if (recovery_force && recovery_rate > 0.0 && 0 == recovery_count)
         {
@@ -219,8 +388,11 @@ bool cm256_encode(uint16_t & frame_index, uint8_t & frame_filter, std::list<std:
             return false;
         }
 
-        dst_data_list.splice(dst_data_list.end(), original_blocks);
-        dst_data_list.splice(dst_data_list.end(), recovery_blocks);
+        {
+            CM256_CODEC_PROFILE_SCOPE(splice_nanoseconds);
+            dst_data_list.splice(dst_data_list.end(), original_blocks);
+            dst_data_list.splice(dst_data_list.end(), recovery_blocks);
+        }
 
         if (0 == ++frame_index)
         {
@@ -231,202 +403,1114 @@ bool cm256_encode(uint16_t & frame_index, uint8_t & frame_filter, std::list<std:
     return true;
 }
 
-static bool insert_frame_block(const void * data, std::size_t data_len, frames_t & frames, uint16_t & frame_index, uint32_t max_delay_microseconds)
+bool cm256_encode_profile(encode_profile_t & profile)
 {
-    const block_t * block = reinterpret_cast<const block_t *>(data);
-    const uint16_t block_size = static_cast<uint16_t>(data_len);
+#ifdef CM256_CODEC_PROFILE
+    profile.original_bytes = s_encode_counters.original_bytes.load();
+    s_encode_counters.original_nanoseconds.load(profile.original_nanoseconds);
+    s_encode_counters.recovery_nanoseconds.load(profile.recovery_nanoseconds);
+    s_encode_counters.cm256_nanoseconds.load(profile.cm256_nanoseconds);
+    s_encode_counters.splice_nanoseconds.load(profile.splice_nanoseconds);
+    return true;
+#else
+    memset(&profile, 0x0, sizeof(profile));
+    return false;
+#endif // CM256_CODEC_PROFILE
+}
 
-    const block_header_t & block_header = block->header;
+static bool flush_stream_frame(stream_encoder_t & encoder, std::list<std::vector<uint8_t>> & dst_data_list)
+{
+    if (encoder.original_list.empty())
+    {
+        return true;
+    }
 
-    frame_index = ntohs(block_header.frame_index);
+    const uint8_t original_count = static_cast<uint8_t>(encoder.original_list.size());
 
-    frame_t & frame = frames.item[frame_index];
-    frame_header_t & frame_header = frame.header;
-    frame_body_t & frame_body = frame.body;
+    std::list<std::vector<uint8_t>> recovery_blocks;
+    recovery_blocks.swap(encoder.recovery_list);
 
-    if (0 == frame_header.block_count)
+    bool ret = true;
+    if (original_count != encoder.original_count)
     {
-        if (0 == frame_header.original_count || 
-            block_size != frame_header.block_size || 
-            block_header.frame_index != frame_header.frame_index || block_header.frame_filter != frame_header.frame_filter || 
-            block_header.original_count != frame_header.original_count || block_header.recovery_count != frame_header.recovery_count)
+        uint8_t recovery_count = get_recovery_count(original_count, encoder.recovery_rate);
+        if (encoder.recovery_force && encoder.recovery_rate > 0.0 && 0 == recovery_count)
         {
-            frame_header.block_size = block_size;
-            frame_header.frame_index = block_header.frame_index;
-            frame_header.frame_filter = block_header.frame_filter;
-            frame_header.original_count = block_header.original_count;
-            frame_header.recovery_count = block_header.recovery_count;
-            memset(frame_header.block_bitmap, 0x0, sizeof(frame_header.block_bitmap));
-            frame_header.block_bitmap[block_header.block_index >> 3] |= (1 << (block_header.block_index & 7));
-            if (block_header.block_index < block_header.original_count)
-            {
-                frame_body.original_list.emplace_back(std::vector<uint8_t>(reinterpret_cast<const uint8_t *>(block), reinterpret_cast<const uint8_t *>(block) + block_size));
-            }
-            else
-            {
-                frame_body.recovery_list.emplace_back(std::vector<uint8_t>(reinterpret_cast<const uint8_t *>(block), reinterpret_cast<const uint8_t *>(block) + block_size));
-            }
-            frame_header.block_count += 1;
-
-            decode_timer_t decode_timer = { 0x0 };
-            decode_timer.frame_index = frame_index;
-            get_current_time(decode_timer.decode_seconds, decode_timer.decode_microseconds);
-            decode_timer.decode_microseconds += max_delay_microseconds * frame_header.original_count;
-            decode_timer.decode_seconds += decode_timer.decode_microseconds / 1000000;
-            decode_timer.decode_microseconds %= 1000000;
+            recovery_count = 1;
+        }
 
-            frames.decode_timer_list.push_back(decode_timer);
+        CM256::cm256_block blocks[256];
 
-            return true;
-        }
-        else
+        uint8_t block_index = 0;
+        for (std::list<std::vector<uint8_t>>::iterator iter = encoder.original_list.begin(); encoder.original_list.end() != iter; ++iter, ++block_index)
         {
-            return false;
+            block_t * block = reinterpret_cast<block_t *>(&(*iter)[0]);
+            blocks[block_index].Block = &block->body;
+            blocks[block_index].Index = block_index;
         }
+
+        recovery_blocks.clear();
+        ret = create_recovery_blocks(blocks, recovery_blocks, encoder.frame_index, encoder.frame_filter, original_count, recovery_count, encoder.block_bytes);
     }
 
-    if (block_size != frame_header.block_size || 
-        block_header.frame_index != frame_header.frame_index || block_header.frame_filter != frame_header.frame_filter || 
-        block_header.original_count != frame_header.original_count || block_header.recovery_count != frame_header.recovery_count)
+    encoder.original_list.clear();
+
+    if (0 == ++encoder.frame_index)
     {
-        return false;
+        ++encoder.frame_filter;
     }
 
-    if (frame_header.block_bitmap[block_header.block_index >> 3] & (1 << (block_header.block_index & 7)))
+    if (!ret)
     {
         return false;
     }
 
-    if (frame_header.block_count == frame_header.original_count)
-    {
-        if (block_header.block_index >= block_header.original_count)
-        {
-            return false;
-        }
-        else
-        {
-            block_t * old_block = reinterpret_cast<block_t *>(&frame_body.recovery_list.back()[0]);
-            frame_header.block_bitmap[old_block->header.block_index >> 3] &= ~(1 << (old_block->header.block_index & 7));
-            frame_body.recovery_list.pop_back();
-            frame_header.block_bitmap[block_header.block_index >> 3] |= (1 << (block_header.block_index & 7));
-            frame_body.original_list.emplace_back(std::vector<uint8_t>(reinterpret_cast<const uint8_t *>(block), reinterpret_cast<const uint8_t *>(block) + block_size));
-        }
-    }
-    else
-    {
-        frame_header.block_bitmap[block_header.block_index >> 3] |= (1 << (block_header.block_index & 7));
-        if (block_header.block_index < block_header.original_count)
-        {
-            frame_body.original_list.emplace_back(std::vector<uint8_t>(reinterpret_cast<const uint8_t *>(block), reinterpret_cast<const uint8_t *>(block) + block_size));
-        }
-        else
-        {
-            frame_body.recovery_list.emplace_back(std::vector<uint8_t>(reinterpret_cast<const uint8_t *>(block), reinterpret_cast<const uint8_t *>(block) + block_size));
-        }
-        frame_header.block_count += 1;
-    }
+    dst_data_list.splice(dst_data_list.end(), recovery_blocks);
 
     return true;
 }
 
-static bool cm256_decode(frame_header_t & frame_header, frame_body_t & frame_body, std::list<std::vector<uint8_t>> & src_data_list)
+static bool accumulate_stream_block(stream_encoder_t & encoder, const block_t * block)
 {
-    frame_header.block_count = 0;
-
-    src_data_list.clear();
-    src_data_list.swap(frame_body.original_list);
-
-    if (!frame_body.recovery_list.empty())
+    if (encoder.recovery_list.empty())
     {
-        if (src_data_list.size() + frame_body.recovery_list.size() == frame_header.original_count)
-        {
-            src_data_list.splice(src_data_list.end(), frame_body.recovery_list);
-
-            CM256::cm256_block blocks[256];
+        return true;
+    }
 
-            std::size_t block_index = 0;
-            for (std::list<std::vector<uint8_t>>::iterator iter = src_data_list.begin(); src_data_list.end() != iter; ++iter)
-            {
-                std::vector<uint8_t> & data = *iter;
-                block_t * block = reinterpret_cast<block_t *>(&data[0]);
-                blocks[block_index].Block = &block->body;
-                blocks[block_index].Index = block->header.block_index;
-                ++block_index;
-            }
+    uint8_t * recovery_data[256] = { 0x0 };
 
-            CM256 cm256;
-            if (!cm256.isInitialized())
-            {
-                return false;
-            }
+    uint8_t block_index = 0;
+    for (std::list<std::vector<uint8_t>>::iterator iter = encoder.recovery_list.begin(); encoder.recovery_list.end() != iter; ++iter, ++block_index)
+    {
+        recovery_data[block_index] = reinterpret_cast<uint8_t *>(&reinterpret_cast<block_t *>(&(*iter)[0])->body);
+    }
 
-            CM256::cm256_encoder_params params = { frame_header.original_count, frame_header.recovery_count, static_cast<int>(frame_header.block_size - sizeof(block_header_t)) };
-            if (0 != cm256.cm256_decode(params, blocks))
-            {
-                return false;
-            }
-        }
-        else
-        {
-            frame_body.recovery_list.clear();
-        }
+    CM256 & cm256 = get_cm256();
+    if (!cm256.isInitialized())
+    {
+        return false;
     }
 
-    for (std::list<std::vector<uint8_t>>::iterator iter = src_data_list.begin(); src_data_list.end() != iter; ++iter)
+    CM256::cm256_block original;
+    original.Block = const_cast<block_body_t *>(&block->body);
+    original.Index = block->header.block_index;
+
+    CM256::cm256_encoder_params params = { encoder.original_count, encoder.recovery_count, static_cast<int>(sizeof(uint16_t) + encoder.block_bytes) };
+    if (0 != cm256.cm256_encode_accumulate(params, original, recovery_data, get_original_bytes(&block->body, params.BlockBytes)))
     {
-        std::vector<uint8_t> & data = *iter;
-        block_t * block = reinterpret_cast<block_t *>(&data[0]);
-        std::vector<uint8_t>(block->body.block_chunk, block->body.block_chunk + ntohs(block->body.block_bytes)).swap(data);
+        return false;
     }
 
     return true;
 }
 
-bool cm256_decode(const void * data, std::size_t data_len, frames_t & frames, std::list<std::vector<uint8_t>> & dst_data_list, uint32_t max_delay_microseconds, bool recovery_force)
+bool cm256_stream_encode(const void * data, std::size_t data_len, stream_encoder_t & encoder, std::list<std::vector<uint8_t>> & dst_data_list, double recovery_rate, std::size_t max_data_size, std::size_t max_original_count, uint32_t max_delay_microseconds, bool recovery_force)
 {
-    bool need_decode = recovery_force;
+    if (recovery_rate < 0.0 || recovery_rate >= 1.0)
+    {
+        return false;
+    }
 
-    if (nullptr != data && 0 != data_len)
+    if (0 == max_data_size || max_data_size >= 65536)
     {
-        uint16_t frame_index = 0;
-        if (insert_frame_block(data, data_len, frames, frame_index, max_delay_microseconds))
+        return false;
+    }
+
+    uint32_t current_seconds = 0;
+    uint32_t current_microseconds = 0;
+    get_current_time(current_seconds, current_microseconds);
+
+    if (!encoder.original_list.empty())
+    {
+        if ((encoder.flush_seconds < current_seconds) || (encoder.flush_seconds == current_seconds && encoder.flush_microseconds < current_microseconds) || 
+            (nullptr != data && 0 != data_len && max_data_size != encoder.block_bytes))
         {
-            const frame_t & frame = frames.item[frame_index];
-            if (frame.header.block_count == frame.header.original_count)
+            if (!flush_stream_frame(encoder, dst_data_list))
             {
-                need_decode = true;
+                return false;
             }
         }
     }
-    else
+
+    if (nullptr == data || 0 == data_len)
     {
-        need_decode = true;
+        return true;
     }
 
-    if (need_decode)
+    if (data_len > max_data_size)
+    {
+        return false;
+    }
+
+    if (encoder.original_list.empty())
     {
-        uint32_t current_seconds = 0;
-        uint32_t current_microseconds = 0;
-        get_current_time(current_seconds, current_microseconds);
-        std::list<decode_timer_t>::iterator iter = frames.decode_timer_list.begin();
-        while (frames.decode_timer_list.end() != iter)
+        encoder.block_bytes = static_cast<uint16_t>(max_data_size);
+        encoder.original_count = get_original_count(recovery_rate, encoder.block_bytes, max_original_count, 0);
+        encoder.recovery_count = get_recovery_count(encoder.original_count, recovery_rate);
+        if (recovery_force && recovery_rate > 0.0 && 0 == encoder.recovery_count)
         {
-            const decode_timer_t & decode_timer = *iter;
-            frame_t & frame = frames.item[decode_timer.frame_index];
-            if ((decode_timer.decode_seconds < current_seconds) || (decode_timer.decode_seconds == current_seconds && decode_timer.decode_microseconds < current_microseconds) || 
-                (frame.header.block_count == frame.header.original_count))
-            {
-                std::list<std::vector<uint8_t>> src_data_list;
-                cm256_decode(frame.header, frame.body, src_data_list);
-                dst_data_list.splice(dst_data_list.end(), src_data_list);
-                iter = frames.decode_timer_list.erase(iter);
-            }
-            else
-            {
-                ++iter;
-            }
+            encoder.recovery_count = 1;
+        }
+        encoder.recovery_rate = recovery_rate;
+        encoder.recovery_force = recovery_force;
+        encoder.flush_microseconds = current_microseconds + max_delay_microseconds;
+        encoder.flush_seconds = current_seconds + encoder.flush_microseconds / 1000000;
+        encoder.flush_microseconds %= 1000000;
+
+        const uint16_t block_size = static_cast<uint16_t>(sizeof(block_header_t) + sizeof(uint16_t) + encoder.block_bytes);
+
+        for (uint8_t block_index = 0; block_index < encoder.recovery_count; ++block_index)
+        {
+            std::vector<uint8_t> recovery_buffer(block_size, 0x0);
+
+            block_t * block = reinterpret_cast<block_t *>(&recovery_buffer[0]);
+            block->header.frame_index = htons(encoder.frame_index);
+            block->header.frame_filter = encoder.frame_filter;
+            block->header.block_index = encoder.original_count + block_index;
+            block->header.original_count = encoder.original_count;
+            block->header.recovery_count = encoder.recovery_count;
+
+            encoder.recovery_list.emplace_back(std::move(recovery_buffer));
         }
     }
 
+    const uint16_t block_size = static_cast<uint16_t>(sizeof(block_header_t) + sizeof(uint16_t) + encoder.block_bytes);
+
+    std::vector<uint8_t> original_buffer(block_size, 0x0);
+
+    block_t * block = reinterpret_cast<block_t *>(&original_buffer[0]);
+    block->header.frame_index = htons(encoder.frame_index);
+    block->header.frame_filter = encoder.frame_filter;
+    block->header.block_index = static_cast<uint8_t>(encoder.original_list.size());
+    block->header.original_count = encoder.original_count;
+    block->header.recovery_count = encoder.recovery_count;
+    memcpy(block->body.block_chunk, data, data_len);
+    block->body.block_bytes = htons(static_cast<uint16_t>(data_len));
+
+    if (!accumulate_stream_block(encoder, block))
+    {
+        return false;
+    }
+
+    dst_data_list.push_back(original_buffer);
+    encoder.original_list.emplace_back(std::move(original_buffer));
+
+    if (encoder.original_list.size() == encoder.original_count)
+    {
+        return flush_stream_frame(encoder, dst_data_list);
+    }
+
+    return true;
+}
+
+bool cm256_stream_flush(stream_encoder_t & encoder, std::list<std::vector<uint8_t>> & dst_data_list)
+{
+    return flush_stream_frame(encoder, dst_data_list);
+}
+
+static bool is_same_frame(const block_header_t & block_header, uint16_t block_size, const frame_header_t & frame_header)
+{
+    if (block_size != frame_header.block_size || 
+        block_header.frame_index != frame_header.frame_index || block_header.frame_filter != frame_header.frame_filter)
+    {
+        return false;
+    }
+
+    if (block_header.original_count == frame_header.original_count && block_header.recovery_count == frame_header.recovery_count)
+    {
+        return true;
+    }
+
+    /* originals streamed before their frame was flushed carry the planned counts, recovery blocks carry the final ones */
+    return block_header.block_index < frame_header.original_count && block_header.original_count > frame_header.original_count;
+}
+
+static bool truncate_frame(const block_header_t & block_header, uint16_t block_size, frame_header_t & frame_header, const frame_body_t & frame_body)
+{
+    if (block_size != frame_header.block_size || 
+        block_header.frame_index != frame_header.frame_index || block_header.frame_filter != frame_header.frame_filter)
+    {
+        return false;
+    }
+
+    if (block_header.block_index < block_header.original_count || block_header.original_count >= frame_header.original_count || !frame_body.recovery_list.empty())
+    {
+        return false;
+    }
+
+    for (uint16_t block_index = block_header.original_count; block_index < frame_header.original_count; ++block_index)
+    {
+        if (frame_header.block_bitmap[block_index >> 3] & (1 << (block_index & 7)))
+        {
+            return false;
+        }
+    }
+
+    frame_header.original_count = block_header.original_count;
+    frame_header.recovery_count = block_header.recovery_count;
+
+    return true;
+}
+
+/*
+ * the only place a datagram becomes a block_t: long enough for the header and the length, a frame of 1..255 blocks
+ * holding the index, and for an original a payload inside the datagram, checked without branching on the content
+ */
+static const block_t * parse_block(const void * data, std::size_t data_len)
+{
+    if (nullptr == data || data_len < sizeof(block_header_t) + sizeof(uint16_t) || data_len > 65535)
+    {
+        return nullptr;
+    }
+
+    const block_t * block = reinterpret_cast<const block_t *>(data);
+    const unsigned block_index = block->header.block_index;
+    const unsigned original_count = block->header.original_count;
+    const unsigned block_count = original_count + block->header.recovery_count;
+    const std::size_t chunk_bytes = data_len - sizeof(block_header_t) - sizeof(uint16_t);
+
+    bool valid = (0 != original_count);
+    valid &= (block_count <= 255);
+    valid &= (block_index < block_count);
+    valid &= (block_index >= original_count) | (ntohs(block->body.block_bytes) <= chunk_bytes);
+
+    return (valid ? block : nullptr);
+}
+
+/* a block that fails parse_block is counted and goes no further, so it never reaches frame state */
+static const block_t * accept_block(const void * data, std::size_t data_len, frames_t & frames)
+{
+    const block_t * block = parse_block(data, data_len);
+    if (nullptr == block)
+    {
+        frames.stats.blocks_received.add(1);
+        frames.stats.blocks_malformed.add(1);
+    }
+    return block;
+}
+
+static bool insert_frame_block(const block_t * block, std::size_t data_len, frames_t & frames, uint16_t & frame_index, uint32_t max_delay_microseconds)
+{
+    const uint16_t block_size = static_cast<uint16_t>(data_len);
+
+    frames.stats.blocks_received.add(1);
+
+    const block_header_t & block_header = block->header;
+
+    frame_index = ntohs(block_header.frame_index);
+
+    frame_t & frame = frames.item[frame_index];
+    frame_header_t & frame_header = frame.header;
+    frame_body_t & frame_body = frame.body;
+
+    if (0 == frame_header.block_count)
+    {
+        if (0 == frame_header.original_count || !is_same_frame(block_header, block_size, frame_header))
+        {
+            frame_header.block_size = block_size;
+            frame_header.frame_index = block_header.frame_index;
+            frame_header.frame_filter = block_header.frame_filter;
+            frame_header.original_count = block_header.original_count;
+            frame_header.recovery_count = block_header.recovery_count;
+            memset(frame_header.block_bitmap, 0x0, sizeof(frame_header.block_bitmap));
+            frame_header.block_bitmap[block_header.block_index >> 3] |= (1 << (block_header.block_index & 7));
+            if (block_header.block_index < block_header.original_count)
+            {
+                frame_body.original_list.emplace_back(std::vector<uint8_t>(reinterpret_cast<const uint8_t *>(block), reinterpret_cast<const uint8_t *>(block) + block_size));
+            }
+            else
+            {
+                frame_body.recovery_list.emplace_back(std::vector<uint8_t>(reinterpret_cast<const uint8_t *>(block), reinterpret_cast<const uint8_t *>(block) + block_size));
+            }
+            frame_header.block_count += 1;
+
+            decode_timer_t decode_timer = { 0x0 };
+            decode_timer.frame_index = frame_index;
+            get_current_time(decode_timer.start_seconds, decode_timer.start_microseconds);
+            decode_timer.decode_seconds = decode_timer.start_seconds;
+            decode_timer.decode_microseconds = decode_timer.start_microseconds + max_delay_microseconds * frame_header.original_count;
+            decode_timer.decode_seconds += decode_timer.decode_microseconds / 1000000;
+            decode_timer.decode_microseconds %= 1000000;
+
+            frames.decode_timer_list.push_back(decode_timer);
+
+            return true;
+        }
+        else
+        {
+            frames.stats.blocks_late.add(1);
+            return false;
+        }
+    }
+
+    if (!is_same_frame(block_header, block_size, frame_header))
+    {
+        if (!truncate_frame(block_header, block_size, frame_header, frame_body))
+        {
+            frames.stats.blocks_mismatch.add(1);
+            return false;
+        }
+
+        if (frame_header.block_count == frame_header.original_count)
+        {
+            return true;
+        }
+    }
+
+    if (frame_header.block_bitmap[block_header.block_index >> 3] & (1 << (block_header.block_index & 7)))
+    {
+        frames.stats.blocks_duplicate.add(1);
+        return false;
+    }
+
+    if (frame_header.block_count == frame_header.original_count)
+    {
+        if (block_header.block_index >= block_header.original_count)
+        {
+            frames.stats.blocks_late.add(1);
+            return false;
+        }
+        else
+        {
+            block_t * old_block = reinterpret_cast<block_t *>(&frame_body.recovery_list.back()[0]);
+            frame_header.block_bitmap[old_block->header.block_index >> 3] &= ~(1 << (old_block->header.block_index & 7));
+            frame_body.recovery_list.pop_back();
+            frame_header.block_bitmap[block_header.block_index >> 3] |= (1 << (block_header.block_index & 7));
+            frame_body.original_list.emplace_back(std::vector<uint8_t>(reinterpret_cast<const uint8_t *>(block), reinterpret_cast<const uint8_t *>(block) + block_size));
+        }
+    }
+    else
+    {
+        frame_header.block_bitmap[block_header.block_index >> 3] |= (1 << (block_header.block_index & 7));
+        if (block_header.block_index < block_header.original_count)
+        {
+            frame_body.original_list.emplace_back(std::vector<uint8_t>(reinterpret_cast<const uint8_t *>(block), reinterpret_cast<const uint8_t *>(block) + block_size));
+        }
+        else
+        {
+            frame_body.recovery_list.emplace_back(std::vector<uint8_t>(reinterpret_cast<const uint8_t *>(block), reinterpret_cast<const uint8_t *>(block) + block_size));
+        }
+        frame_header.block_count += 1;
+    }
+
+    return true;
+}
+
+struct frame_result_t
+{
+    bool                                recovered;
+    bool                                failed;
+    std::size_t                         recovered_blocks;
+    uint64_t                            decode_nanoseconds;
+};
+
+static bool is_block_before(const std::vector<uint8_t> & lhs, const std::vector<uint8_t> & rhs)
+{
+    return reinterpret_cast<const block_header_t *>(&lhs[0])->block_index < reinterpret_cast<const block_header_t *>(&rhs[0])->block_index;
+}
+
+/* touches nothing but its arguments, so frames may be decoded on any thread */
+static bool decode_frame(const frame_header_t & frame_header, frame_body_t & frame_body, std::list<std::vector<uint8_t>> & src_data_list, frame_result_t & result, bool sort_blocks)
+{
+    src_data_list.clear();
+    src_data_list.swap(frame_body.original_list);
+
+    if (!frame_body.recovery_list.empty())
+    {
+        if (src_data_list.size() + frame_body.recovery_list.size() == frame_header.original_count)
+        {
+            const std::size_t recovered_blocks = frame_body.recovery_list.size();
+            const std::chrono::steady_clock::time_point decode_begin = std::chrono::steady_clock::now();
+
+            src_data_list.splice(src_data_list.end(), frame_body.recovery_list);
+
+            CM256::cm256_block blocks[256];
+            int block_bytes[256];
+
+            CM256::cm256_encoder_params params = { frame_header.original_count, frame_header.recovery_count, static_cast<int>(frame_header.block_size - sizeof(block_header_t)) };
+
+            std::size_t block_index = 0;
+            for (std::list<std::vector<uint8_t>>::iterator iter = src_data_list.begin(); src_data_list.end() != iter; ++iter)
+            {
+                std::vector<uint8_t> & data = *iter;
+                block_t * block = reinterpret_cast<block_t *>(&data[0]);
+                blocks[block_index].Block = &block->body;
+                blocks[block_index].Index = block->header.block_index;
+                block_bytes[block_index] = (block->header.block_index < frame_header.original_count ? get_original_bytes(&block->body, params.BlockBytes) : params.BlockBytes);
+                ++block_index;
+            }
+
+            CM256 & cm256 = get_cm256();
+            if (!cm256.isInitialized())
+            {
+                return false;
+            }
+
+            if (0 != cm256.cm256_decode(params, blocks, block_bytes))
+            {
+                result.failed = true;
+                return false;
+            }
+
+            /* a recovered block takes the index of the original it replaces */
+            for (std::size_t index = 0; index < block_index; ++index)
+            {
+                reinterpret_cast<block_header_t *>(reinterpret_cast<uint8_t *>(blocks[index].Block) - sizeof(block_header_t))->block_index = blocks[index].Index;
+            }
+
+            result.recovered = true;
+            result.recovered_blocks = recovered_blocks;
+            result.decode_nanoseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - decode_begin).count());
+        }
+        else
+        {
+            frame_body.recovery_list.clear();
+        }
+    }
+
+    if (sort_blocks)
+    {
+        src_data_list.sort(is_block_before);
+    }
+
+    /* a recovered length comes out of the solve, a frame fed inconsistent blocks can recover one past its block */
+    for (std::list<std::vector<uint8_t>>::iterator iter = src_data_list.begin(); src_data_list.end() != iter; )
+    {
+        std::vector<uint8_t> & data = *iter;
+        block_t * block = reinterpret_cast<block_t *>(&data[0]);
+        const std::size_t chunk_bytes = ntohs(block->body.block_bytes);
+        if (chunk_bytes > data.size() - sizeof(block_header_t) - sizeof(uint16_t))
+        {
+            iter = src_data_list.erase(iter);
+            result.failed = true;
+            continue;
+        }
+        std::vector<uint8_t>(block->body.block_chunk, block->body.block_chunk + chunk_bytes).swap(data);
+        ++iter;
+    }
+
+    return true;
+}
+
+static void update_decode_stats(decode_counters_t & stats, const frame_result_t & result)
+{
+    if (result.failed)
+    {
+        stats.frames_failed.add(1);
+    }
+    if (result.recovered)
+    {
+        stats.frames_recovered.add(1);
+        stats.blocks_recovered.add(result.recovered_blocks);
+        stats.recovered_blocks.add(result.recovered_blocks);
+        stats.decode_nanoseconds.add(result.decode_nanoseconds);
+    }
+}
+
+static bool cm256_decode(frame_header_t & frame_header, frame_body_t & frame_body, std::list<std::vector<uint8_t>> & src_data_list, decode_counters_t & stats, bool sort_blocks = false)
+{
+    frame_header.block_count = 0;
+
+    frame_result_t result = { false, false, 0, 0 };
+    const bool ret = decode_frame(frame_header, frame_body, src_data_list, result, sort_blocks);
+    update_decode_stats(stats, result);
+    return ret;
+}
+
+static std::size_t get_frame_bytes(const frame_t & frame)
+{
+    return (frame.body.original_list.size() + frame.body.recovery_list.size()) * frame.header.block_size;
+}
+
+template <typename Deliver>
+static void expire_frames(frames_t & frames, bool flush_all, Deliver deliver)
+{
+    uint32_t current_seconds = 0;
+    uint32_t current_microseconds = 0;
+    get_current_time(current_seconds, current_microseconds);
+    std::list<decode_timer_t>::iterator iter = frames.decode_timer_list.begin();
+    while (frames.decode_timer_list.end() != iter)
+    {
+        const decode_timer_t & decode_timer = *iter;
+        frame_t & frame = frames.item[decode_timer.frame_index];
+        if (flush_all || (decode_timer.decode_seconds < current_seconds) || (decode_timer.decode_seconds == current_seconds && decode_timer.decode_microseconds < current_microseconds) || 
+            (frame.header.block_count == frame.header.original_count))
+        {
+            if (frame.header.block_count == frame.header.original_count)
+            {
+                frames.stats.frames_complete.add(1);
+            }
+            else
+            {
+                frames.stats.frames_expired.add(1);
+            }
+            const int64_t frame_microseconds = (static_cast<int64_t>(current_seconds) - decode_timer.start_seconds) * 1000000 + (static_cast<int64_t>(current_microseconds) - decode_timer.start_microseconds);
+            frames.stats.frame_microseconds.add(frame_microseconds > 0 ? static_cast<uint64_t>(frame_microseconds) : 0);
+
+            deliver(frame);
+            iter = frames.decode_timer_list.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
+static void decode_frames(frames_t & frames, std::list<std::vector<uint8_t>> & dst_data_list)
+{
+    expire_frames(frames, false, [&](frame_t & frame)
+    {
+        std::list<std::vector<uint8_t>> src_data_list;
+        cm256_decode(frame.header, frame.body, src_data_list, frames.stats);
+        dst_data_list.splice(dst_data_list.end(), src_data_list);
+    });
+}
+
+bool cm256_decode(const void * data, std::size_t data_len, frames_t & frames, std::list<std::vector<uint8_t>> & dst_data_list, uint32_t max_delay_microseconds, bool recovery_force)
+{
+    bool need_decode = recovery_force;
+
+    if (nullptr != data && 0 != data_len)
+    {
+        const block_t * block = accept_block(data, data_len, frames);
+        if (nullptr == block)
+        {
+            return false;
+        }
+
+        uint16_t frame_index = 0;
+        if (insert_frame_block(block, data_len, frames, frame_index, max_delay_microseconds))
+        {
+            const frame_t & frame = frames.item[frame_index];
+            if (frame.header.block_count == frame.header.original_count)
+            {
+                need_decode = true;
+            }
+        }
+    }
+    else
+    {
+        need_decode = true;
+    }
+
+    if (need_decode)
+    {
+        decode_frames(frames, dst_data_list);
+    }
+
+    return true;
+}
+
+void cm256_decode_stats(const frames_t & frames, decode_stats_t & stats)
+{
+    const decode_counters_t & counters = frames.stats;
+    stats.blocks_received = counters.blocks_received.load();
+    stats.blocks_duplicate = counters.blocks_duplicate.load();
+    stats.blocks_late = counters.blocks_late.load();
+    stats.blocks_mismatch = counters.blocks_mismatch.load();
+    stats.blocks_corrupt = counters.blocks_corrupt.load();
+    stats.blocks_malformed = counters.blocks_malformed.load();
+    stats.blocks_recovered = counters.blocks_recovered.load();
+    stats.frames_complete = counters.frames_complete.load();
+    stats.frames_recovered = counters.frames_recovered.load();
+    stats.frames_expired = counters.frames_expired.load();
+    stats.frames_failed = counters.frames_failed.load();
+    stats.frames_evicted = counters.frames_evicted.load();
+    stats.frames_skipped = counters.frames_skipped.load();
+    stats.frames_late = counters.frames_late.load();
+    counters.frame_microseconds.load(stats.frame_microseconds);
+    counters.decode_nanoseconds.load(stats.decode_nanoseconds);
+    counters.recovered_blocks.load(stats.recovered_blocks);
+}
+
+cm256_decoder_t * cm256_decoder_create(uint32_t max_delay_microseconds, std::size_t max_frame_count, std::size_t max_buffer_bytes)
+{
+    if (0 == max_frame_count || 0 == max_buffer_bytes)
+    {
+        return nullptr;
+    }
+
+    cm256_decoder_t * decoder = new cm256_decoder_t;
+    decoder->max_delay_microseconds = max_delay_microseconds;
+    decoder->max_frame_count = max_frame_count;
+    decoder->max_buffer_bytes = max_buffer_bytes;
+    decoder->buffer_bytes = 0;
+    decoder->in_order = false;
+    decoder->max_hold_frames = 0;
+    decoder->max_hold_microseconds = 0;
+    decoder->order_started = false;
+    decoder->order_sequence = 0;
+    decoder->wire_checksum = false;
+    return decoder;
+}
+
+void cm256_decoder_destroy(cm256_decoder_t * decoder)
+{
+    delete decoder;
+}
+
+/* the order starts at the first frame seen, not the first decoded, which may have completed ahead of it */
+static void start_order(cm256_decoder_t & decoder, uint16_t frame_index)
+{
+    if (!decoder.order_started)
+    {
+        /* far from zero so that frames just behind the first one still compare below it */
+        decoder.order_sequence = (static_cast<uint64_t>(1) << 32) + frame_index;
+        decoder.order_started = true;
+    }
+}
+
+static void hold_frame(cm256_decoder_t & decoder, uint16_t frame_index, std::list<std::vector<uint8_t>> & src_data_list)
+{
+    start_order(decoder, frame_index);
+
+    const uint64_t sequence = decoder.order_sequence + static_cast<int16_t>(static_cast<uint16_t>(frame_index - static_cast<uint16_t>(decoder.order_sequence)));
+    if (sequence < decoder.order_sequence)
+    {
+        decoder.frames.stats.frames_late.add(1);
+        return;
+    }
+
+    order_frame_t & order_frame = decoder.order_map[sequence];
+    order_frame.data_list.swap(src_data_list);
+    get_current_time(order_frame.release_seconds, order_frame.release_microseconds);
+    order_frame.release_microseconds += decoder.max_hold_microseconds;
+    order_frame.release_seconds += order_frame.release_microseconds / 1000000;
+    order_frame.release_microseconds %= 1000000;
+}
+
+static bool is_hold_expired(const cm256_decoder_t & decoder)
+{
+    uint32_t current_seconds = 0;
+    uint32_t current_microseconds = 0;
+    get_current_time(current_seconds, current_microseconds);
+    for (std::map<uint64_t, order_frame_t>::const_iterator iter = decoder.order_map.begin(); decoder.order_map.end() != iter; ++iter)
+    {
+        const order_frame_t & order_frame = iter->second;
+        if ((order_frame.release_seconds < current_seconds) || (order_frame.release_seconds == current_seconds && order_frame.release_microseconds < current_microseconds))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* the frame whose turn it is still has blocks in flight, it comes out by its own deadline at the latest */
+static bool is_order_frame_pending(const cm256_decoder_t & decoder)
+{
+    const uint16_t frame_index = static_cast<uint16_t>(decoder.order_sequence);
+    std::map<uint16_t, frame_t>::const_iterator iter = decoder.frames.item.find(frame_index);
+    return (decoder.frames.item.end() != iter && 0 != iter->second.header.block_count && frame_index == ntohs(iter->second.header.frame_index));
+}
+
+static void release_frames(cm256_decoder_t & decoder, std::list<std::vector<uint8_t>> & dst_data_list, bool flush_all)
+{
+    while (!decoder.order_map.empty())
+    {
+        std::map<uint64_t, order_frame_t>::iterator iter = decoder.order_map.begin();
+        if (iter->first != decoder.order_sequence)
+        {
+            if (!flush_all && decoder.in_order && decoder.order_map.size() <= decoder.max_hold_frames && (is_order_frame_pending(decoder) || !is_hold_expired(decoder)))
+            {
+                break;
+            }
+            decoder.frames.stats.frames_skipped.add(iter->first - decoder.order_sequence);
+            decoder.order_sequence = iter->first;
+        }
+        dst_data_list.splice(dst_data_list.end(), iter->second.data_list);
+        decoder.order_map.erase(iter);
+        ++decoder.order_sequence;
+    }
+}
+
+static void deliver_frame(cm256_decoder_t & decoder, frame_t & frame, std::list<std::vector<uint8_t>> & dst_data_list)
+{
+    decoder.buffer_bytes -= get_frame_bytes(frame);
+
+    std::list<std::vector<uint8_t>> src_data_list;
+    cm256_decode(frame.header, frame.body, src_data_list, decoder.frames.stats, decoder.in_order);
+    if (decoder.in_order)
+    {
+        hold_frame(decoder, ntohs(frame.header.frame_index), src_data_list);
+    }
+    else
+    {
+        dst_data_list.splice(dst_data_list.end(), src_data_list);
+    }
+}
+
+static void evict_frames(cm256_decoder_t & decoder, std::list<std::vector<uint8_t>> & dst_data_list)
+{
+    frames_t & frames = decoder.frames;
+    while (!frames.decode_timer_list.empty() && (frames.decode_timer_list.size() > decoder.max_frame_count || decoder.buffer_bytes > decoder.max_buffer_bytes))
+    {
+        /* the oldest frame goes first, its originals are delivered as on expiry */
+        frame_t & frame = frames.item[frames.decode_timer_list.front().frame_index];
+        frames.stats.frames_evicted.add(1);
+        deliver_frame(decoder, frame, dst_data_list);
+        frames.decode_timer_list.pop_front();
+    }
+}
+
+bool cm256_decoder_decode(cm256_decoder_t * decoder, const void * data, std::size_t data_len, std::list<std::vector<uint8_t>> & dst_data_list, bool recovery_force)
+{
+    if (nullptr == decoder)
+    {
+        return false;
+    }
+
+    frames_t & frames = decoder->frames;
+    bool need_decode = recovery_force;
+
+    /* the trailer is checked apart from the rest, so a corrupted block is counted as such */
+    if (nullptr != data && 0 != data_len && decoder->wire_checksum)
+    {
+        if (!cm256_wire_verify(data, data_len))
+        {
+            frames.stats.blocks_received.add(1);
+            frames.stats.blocks_corrupt.add(1);
+            return false;
+        }
+        data_len -= sizeof(uint32_t);
+    }
+
+    if (nullptr != data && 0 != data_len && 1 != decoder->wire_format.version)
+    {
+        if (!cm256_wire_unpack(decoder->wire_format, data, data_len, decoder->wire_block))
+        {
+            frames.stats.blocks_received.add(1);
+            frames.stats.blocks_malformed.add(1);
+            return false;
+        }
+        data = &decoder->wire_block[0];
+        data_len = decoder->wire_block.size();
+    }
+
+    if (nullptr != data && 0 != data_len)
+    {
+        const block_t * block = accept_block(data, data_len, frames);
+        if (nullptr == block)
+        {
+            return false;
+        }
+
+        const uint16_t frame_index = ntohs(block->header.frame_index);
+        if (decoder->in_order)
+        {
+            start_order(*decoder, frame_index);
+        }
+        std::map<uint16_t, frame_t>::const_iterator iter = frames.item.find(frame_index);
+        const std::size_t frame_bytes = (frames.item.end() != iter ? get_frame_bytes(iter->second) : 0);
+
+        uint16_t block_frame_index = 0;
+        if (insert_frame_block(block, data_len, frames, block_frame_index, decoder->max_delay_microseconds))
+        {
+            const frame_t & frame = frames.item[frame_index];
+            decoder->buffer_bytes += get_frame_bytes(frame);
+            decoder->buffer_bytes -= frame_bytes;
+            if (frame.header.block_count == frame.header.original_count)
+            {
+                need_decode = true;
+            }
+        }
+    }
+    else
+    {
+        need_decode = true;
+    }
+
+    if (need_decode)
+    {
+        expire_frames(frames, false, [&](frame_t & frame)
+        {
+            deliver_frame(*decoder, frame, dst_data_list);
+        });
+    }
+
+    evict_frames(*decoder, dst_data_list);
+    release_frames(*decoder, dst_data_list, false);
+
+    return true;
+}
+
+bool cm256_decoder_set_in_order(cm256_decoder_t * decoder, bool in_order, std::size_t max_hold_frames, uint32_t max_hold_microseconds)
+{
+    if (nullptr == decoder)
+    {
+        return false;
+    }
+
+    decoder->in_order = in_order;
+    decoder->max_hold_frames = max_hold_frames;
+    decoder->max_hold_microseconds = max_hold_microseconds;
+    return true;
+}
+
+bool cm256_decoder_set_wire_format(cm256_decoder_t * decoder, const wire_format_t & format)
+{
+    if (nullptr == decoder || (1 != format.version && 2 != format.version))
+    {
+        return false;
+    }
+
+    decoder->wire_format = format;
+    decoder->wire_format.checksum = false;
+    decoder->wire_checksum = format.checksum;
+    return true;
+}
+
+bool cm256_decoder_flush(cm256_decoder_t * decoder, std::list<std::vector<uint8_t>> & dst_data_list)
+{
+    if (nullptr == decoder)
+    {
+        return false;
+    }
+
+    expire_frames(decoder->frames, true, [&](frame_t & frame)
+    {
+        deliver_frame(*decoder, frame, dst_data_list);
+    });
+    release_frames(*decoder, dst_data_list, true);
+    return true;
+}
+
+bool cm256_decoder_stats(const cm256_decoder_t * decoder, decode_stats_t & stats)
+{
+    if (nullptr == decoder)
+    {
+        return false;
+    }
+
+    cm256_decode_stats(decoder->frames, stats);
+    return true;
+}
+
+struct parallel_job_t
+{
+    uint64_t                            sequence;
+    frame_header_t                      header;
+    frame_body_t                        body;
+    std::list<std::vector<uint8_t>>     data_list;
+    frame_result_t                      result;
+};
+
+/*
+ * blocks are inserted and frames expired on the calling thread, the workers only run decode_frame,
+ * results are taken back in dispatch order so the output matches cm256_decoder_decode
+ */
+struct cm256_parallel_decoder_t
+{
+    frames_t                            frames;
+    uint32_t                            max_delay_microseconds;
+    std::size_t                         max_pending_count;
+    std::vector<std::thread>            worker_list;
+    std::mutex                          mutex;
+    std::condition_variable             job_condition;
+    std::condition_variable             done_condition;
+    std::list<parallel_job_t *>         job_list;
+    std::map<uint64_t, parallel_job_t *> done_map;
+    uint64_t                            next_sequence;
+    uint64_t                            deliver_sequence;
+    bool                                running;
+};
+
+static void run_parallel_worker(cm256_parallel_decoder_t * decoder)
+{
+    std::unique_lock<std::mutex> lock(decoder->mutex);
+    while (true)
+    {
+        while (decoder->running && decoder->job_list.empty())
+        {
+            decoder->job_condition.wait(lock);
+        }
+        if (decoder->job_list.empty())
+        {
+            break;
+        }
+
+        parallel_job_t * job = decoder->job_list.front();
+        decoder->job_list.pop_front();
+        lock.unlock();
+
+        decode_frame(job->header, job->body, job->data_list, job->result, false);
+
+        lock.lock();
+        decoder->done_map.insert(std::make_pair(job->sequence, job));
+        decoder->done_condition.notify_all();
+    }
+}
+
+static void collect_parallel_jobs(cm256_parallel_decoder_t & decoder, std::list<std::vector<uint8_t>> & dst_data_list, std::size_t max_pending_count)
+{
+    std::list<parallel_job_t *> job_list;
+    {
+        std::unique_lock<std::mutex> lock(decoder.mutex);
+        while (true)
+        {
+            std::map<uint64_t, parallel_job_t *>::iterator iter = decoder.done_map.begin();
+            if (decoder.done_map.end() != iter && iter->first == decoder.deliver_sequence)
+            {
+                job_list.push_back(iter->second);
+                decoder.done_map.erase(iter);
+                ++decoder.deliver_sequence;
+            }
+            else if (decoder.next_sequence - decoder.deliver_sequence > max_pending_count)
+            {
+                decoder.done_condition.wait(lock);
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    for (std::list<parallel_job_t *>::iterator iter = job_list.begin(); job_list.end() != iter; ++iter)
+    {
+        parallel_job_t * job = *iter;
+        update_decode_stats(decoder.frames.stats, job->result);
+        dst_data_list.splice(dst_data_list.end(), job->data_list);
+        delete job;
+    }
+}
+
+static void dispatch_parallel_jobs(cm256_parallel_decoder_t & decoder, bool flush_all)
+{
+    std::list<parallel_job_t *> job_list;
+    expire_frames(decoder.frames, flush_all, [&](frame_t & frame)
+    {
+        parallel_job_t * job = new parallel_job_t;
+        job->sequence = decoder.next_sequence++;
+        job->header = frame.header;
+        job->body.original_list.swap(frame.body.original_list);
+        job->body.recovery_list.swap(frame.body.recovery_list);
+        job->result.recovered = false;
+        job->result.failed = false;
+        job->result.recovered_blocks = 0;
+        job->result.decode_nanoseconds = 0;
+        frame.header.block_count = 0;
+        job_list.push_back(job);
+    });
+
+    if (!job_list.empty())
+    {
+        std::lock_guard<std::mutex> lock(decoder.mutex);
+        decoder.job_list.splice(decoder.job_list.end(), job_list);
+        decoder.job_condition.notify_all();
+    }
+}
+
+cm256_parallel_decoder_t * cm256_parallel_decoder_create(std::size_t worker_count, uint32_t max_delay_microseconds, std::size_t max_pending_count)
+{
+    if (0 == worker_count || 0 == max_pending_count)
+    {
+        return nullptr;
+    }
+
+    cm256_parallel_decoder_t * decoder = new cm256_parallel_decoder_t;
+    decoder->max_delay_microseconds = max_delay_microseconds;
+    decoder->max_pending_count = max_pending_count;
+    decoder->next_sequence = 0;
+    decoder->deliver_sequence = 0;
+    decoder->running = true;
+
+    for (std::size_t index = 0; index < worker_count; ++index)
+    {
+        decoder->worker_list.push_back(std::thread(run_parallel_worker, decoder));
+    }
+
+    return decoder;
+}
+
+void cm256_parallel_decoder_destroy(cm256_parallel_decoder_t * decoder)
+{
+    if (nullptr == decoder)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(decoder->mutex);
+        decoder->running = false;
+        decoder->job_condition.notify_all();
+    }
+
+    for (std::size_t index = 0; index < decoder->worker_list.size(); ++index)
+    {
+        decoder->worker_list[index].join();
+    }
+
+    for (std::map<uint64_t, parallel_job_t *>::iterator iter = decoder->done_map.begin(); decoder->done_map.end() != iter; ++iter)
+    {
+        delete iter->second;
+    }
+
+    delete decoder;
+}
+
+bool cm256_parallel_decoder_decode(cm256_parallel_decoder_t * decoder, const void * data, std::size_t data_len, std::list<std::vector<uint8_t>> & dst_data_list, bool recovery_force)
+{
+    if (nullptr == decoder)
+    {
+        return false;
+    }
+
+    frames_t & frames = decoder->frames;
+    bool need_decode = recovery_force;
+
+    if (nullptr != data && 0 != data_len)
+    {
+        const block_t * block = accept_block(data, data_len, frames);
+        if (nullptr == block)
+        {
+            return false;
+        }
+
+        uint16_t frame_index = 0;
+        if (insert_frame_block(block, data_len, frames, frame_index, decoder->max_delay_microseconds))
+        {
+            const frame_t & frame = frames.item[frame_index];
+            if (frame.header.block_count == frame.header.original_count)
+            {
+                need_decode = true;
+            }
+        }
+    }
+    else
+    {
+        need_decode = true;
+    }
+
+    if (need_decode)
+    {
+        dispatch_parallel_jobs(*decoder, false);
+    }
+
+    collect_parallel_jobs(*decoder, dst_data_list, decoder->max_pending_count);
+
+    return true;
+}
+
+bool cm256_parallel_decoder_flush(cm256_parallel_decoder_t * decoder, std::list<std::vector<uint8_t>> & dst_data_list)
+{
+    if (nullptr == decoder)
+    {
+        return false;
+    }
+
+    dispatch_parallel_jobs(*decoder, true);
+    collect_parallel_jobs(*decoder, dst_data_list, 0);
+    return true;
+}
+
+bool cm256_parallel_decoder_stats(const cm256_parallel_decoder_t * decoder, decode_stats_t & stats)
+{
+    if (nullptr == decoder)
+    {
+        return false;
+    }
+
+    cm256_decode_stats(decoder->frames, stats);
     return true;
 }
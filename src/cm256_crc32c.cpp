@@ -0,0 +1,196 @@
+/********************************************************
+ * Description : crc32c (castagnoli) checksum
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+    #include <nmmintrin.h>
+    #define CM256_CRC32C_SSE42
+    #define CM256_CRC32C_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #include <nmmintrin.h>
+    #define CM256_CRC32C_SSE42
+    #define CM256_CRC32C_TARGET __attribute__((target("sse4.2")))
+#endif
+
+#include "cm256_crc32c.h"
+
+/* reflected castagnoli polynomial */
+static const uint32_t CRC32C_POLYNOMIAL = 0x82F63B78;
+
+/* the hardware path runs three streams of this many bytes side by side, to hide the latency of crc32 */
+static const std::size_t CRC32C_STRIDE_BYTES = 128;
+
+struct crc32c_table_t
+{
+    uint32_t                            item[8][256];
+    /* register advanced over one and two strides of zeros, one table per byte of the register */
+    uint32_t                            shift_stride[4][256];
+    uint32_t                            shift_stride2[4][256];
+
+    crc32c_table_t()
+    {
+        for (uint32_t index = 0; index < 256; ++index)
+        {
+            uint32_t crc = index;
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc >> 1) ^ (CRC32C_POLYNOMIAL & (0U - (crc & 1)));
+            }
+            item[0][index] = crc;
+        }
+        for (uint32_t index = 0; index < 256; ++index)
+        {
+            for (int slice = 1; slice < 8; ++slice)
+            {
+                item[slice][index] = (item[slice - 1][index] >> 8) ^ item[0][item[slice - 1][index] & 0xFF];
+            }
+        }
+        for (uint32_t index = 0; index < 256; ++index)
+        {
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                uint32_t crc = index << (8 * lane);
+                for (std::size_t count = 0; count < CRC32C_STRIDE_BYTES; ++count)
+                {
+                    crc = (crc >> 8) ^ item[0][crc & 0xFF];
+                }
+                shift_stride[lane][index] = crc;
+                for (std::size_t count = 0; count < CRC32C_STRIDE_BYTES; ++count)
+                {
+                    crc = (crc >> 8) ^ item[0][crc & 0xFF];
+                }
+                shift_stride2[lane][index] = crc;
+            }
+        }
+    }
+};
+
+static const crc32c_table_t & get_crc32c_table()
+{
+    static const crc32c_table_t s_crc32c_table;
+    return s_crc32c_table;
+}
+
+static uint32_t crc32c_table(const uint8_t * data, std::size_t data_len, uint32_t crc)
+{
+    const crc32c_table_t & table = get_crc32c_table();
+
+    for (; 0 != data_len && 0 != (reinterpret_cast<uintptr_t>(data) & 7); --data_len)
+    {
+        crc = (crc >> 8) ^ table.item[0][(crc ^ *data++) & 0xFF];
+    }
+
+    /* eight bytes per step, each through its own table, so the lookups do not wait on each other */
+    for (; data_len >= 8; data_len -= 8, data += 8)
+    {
+        uint32_t low = 0;
+        uint32_t high = 0;
+        memcpy(&low, data, 4);
+        memcpy(&high, data + 4, 4);
+        low ^= crc;
+        crc = table.item[7][low & 0xFF] ^ table.item[6][(low >> 8) & 0xFF] ^ table.item[5][(low >> 16) & 0xFF] ^ table.item[4][low >> 24] ^ 
+            table.item[3][high & 0xFF] ^ table.item[2][(high >> 8) & 0xFF] ^ table.item[1][(high >> 16) & 0xFF] ^ table.item[0][high >> 24];
+    }
+
+    for (; 0 != data_len; --data_len)
+    {
+        crc = (crc >> 8) ^ table.item[0][(crc ^ *data++) & 0xFF];
+    }
+
+    return crc;
+}
+
+#ifdef CM256_CRC32C_SSE42
+
+CM256_CRC32C_TARGET static uint32_t crc32c_sse42(const uint8_t * data, std::size_t data_len, uint32_t crc)
+{
+    for (; 0 != data_len && 0 != (reinterpret_cast<uintptr_t>(data) & 7); --data_len)
+    {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+
+#if defined(__x86_64__) || defined(_M_X64)
+    /* the register is linear in its start value, so the second and third streams start from zero and are shifted into place */
+    const crc32c_table_t & table = get_crc32c_table();
+    for (; data_len >= 3 * CRC32C_STRIDE_BYTES; data_len -= 3 * CRC32C_STRIDE_BYTES, data += 3 * CRC32C_STRIDE_BYTES)
+    {
+        uint64_t crc0 = crc;
+        uint64_t crc1 = 0;
+        uint64_t crc2 = 0;
+        for (std::size_t offset = 0; offset < CRC32C_STRIDE_BYTES; offset += 8)
+        {
+            uint64_t value0 = 0;
+            uint64_t value1 = 0;
+            uint64_t value2 = 0;
+            memcpy(&value0, data + offset, 8);
+            memcpy(&value1, data + CRC32C_STRIDE_BYTES + offset, 8);
+            memcpy(&value2, data + 2 * CRC32C_STRIDE_BYTES + offset, 8);
+            crc0 = _mm_crc32_u64(crc0, value0);
+            crc1 = _mm_crc32_u64(crc1, value1);
+            crc2 = _mm_crc32_u64(crc2, value2);
+        }
+        const uint32_t low0 = static_cast<uint32_t>(crc0);
+        const uint32_t low1 = static_cast<uint32_t>(crc1);
+        crc = static_cast<uint32_t>(crc2) ^ 
+            table.shift_stride2[0][low0 & 0xFF] ^ table.shift_stride2[1][(low0 >> 8) & 0xFF] ^ table.shift_stride2[2][(low0 >> 16) & 0xFF] ^ table.shift_stride2[3][low0 >> 24] ^ 
+            table.shift_stride[0][low1 & 0xFF] ^ table.shift_stride[1][(low1 >> 8) & 0xFF] ^ table.shift_stride[2][(low1 >> 16) & 0xFF] ^ table.shift_stride[3][low1 >> 24];
+    }
+
+    uint64_t crc64 = crc;
+    for (; data_len >= 8; data_len -= 8, data += 8)
+    {
+        uint64_t value = 0;
+        memcpy(&value, data, 8);
+        crc64 = _mm_crc32_u64(crc64, value);
+    }
+    crc = static_cast<uint32_t>(crc64);
+#endif // __x86_64__ || _M_X64
+
+    for (; data_len >= 4; data_len -= 4, data += 4)
+    {
+        uint32_t value = 0;
+        memcpy(&value, data, 4);
+        crc = _mm_crc32_u32(crc, value);
+    }
+
+    for (; 0 != data_len; --data_len)
+    {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+
+    return crc;
+}
+
+static bool has_sse42()
+{
+#ifdef _MSC_VER
+    int info[4] = { 0 };
+    __cpuid(info, 1);
+    return 0 != (info[2] & (1 << 20));
+#else
+    return 0 != __builtin_cpu_supports("sse4.2");
+#endif // _MSC_VER
+}
+
+#endif // CM256_CRC32C_SSE42
+
+uint32_t cm256_crc32c(const void * data, std::size_t data_len, uint32_t crc)
+{
+    const uint8_t * bytes = reinterpret_cast<const uint8_t *>(data);
+
+    crc = ~crc;
+#ifdef CM256_CRC32C_SSE42
+    static const bool s_has_sse42 = has_sse42();
+    if (s_has_sse42)
+    {
+        return ~crc32c_sse42(bytes, data_len, crc);
+    }
+#endif // CM256_CRC32C_SSE42
+    return ~crc32c_table(bytes, data_len, crc);
+}
@@ -0,0 +1,351 @@
+/********************************************************
+ * Description : cm256 multi-stream decoder
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+
+#include "cm256_multi.h"
+
+struct multi_message_t
+{
+    std::atomic<multi_message_t *>      next;
+    uint64_t                            stream_id;
+    bool                                close;
+    std::vector<uint8_t>                data;
+};
+
+/*
+ * intrusive mpsc queue (Vyukov): producers swap themselves in at the head, the single consumer
+ * walks from the tail, a push that races with pop may be invisible for a moment but never lost
+ */
+class multi_queue_t
+{
+public:
+    multi_queue_t()
+        : m_stub()
+        , m_head(&m_stub)
+        , m_tail(&m_stub)
+    {
+        m_stub.next.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~multi_queue_t()
+    {
+        multi_message_t * message = nullptr;
+        while (nullptr != (message = pop()))
+        {
+            delete message;
+        }
+    }
+
+    void push(multi_message_t * message)
+    {
+        message->next.store(nullptr, std::memory_order_relaxed);
+        multi_message_t * prev = m_head.exchange(message, std::memory_order_seq_cst);
+        prev->next.store(message, std::memory_order_seq_cst);
+    }
+
+    multi_message_t * pop()
+    {
+        multi_message_t * tail = m_tail;
+        multi_message_t * next = tail->next.load(std::memory_order_acquire);
+        if (&m_stub == tail)
+        {
+            if (nullptr == next)
+            {
+                return nullptr;
+            }
+            m_tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (nullptr != next)
+        {
+            m_tail = next;
+            return tail;
+        }
+        if (m_head.load(std::memory_order_acquire) != tail)
+        {
+            return nullptr;
+        }
+        push(&m_stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (nullptr != next)
+        {
+            m_tail = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+    bool empty() const
+    {
+        return m_tail == &m_stub ? nullptr == m_stub.next.load(std::memory_order_seq_cst) : false;
+    }
+
+private:
+    multi_message_t                     m_stub;
+    std::atomic<multi_message_t *>      m_head;
+    multi_message_t                   * m_tail;
+};
+
+struct multi_shard_t
+{
+    multi_queue_t                       queue;
+    std::atomic<bool>                   sleeping;
+    std::mutex                          mutex;
+    std::condition_variable             condition;
+    std::thread                         thread;
+    std::unordered_map<uint64_t, cm256_decoder_t *>                         stream_map;
+    std::unordered_map<uint64_t, std::list<std::vector<uint8_t>>>           output_map;
+
+    multi_shard_t()
+        : queue()
+        , sleeping(false)
+        , mutex()
+        , condition()
+        , thread()
+        , stream_map()
+        , output_map()
+    {
+    }
+};
+
+struct cm256_multi_decoder_t
+{
+    std::vector<multi_shard_t *>        shard_list;
+    cm256_multi_deliver_t               deliver;
+    void                              * context;
+    uint32_t                            max_delay_microseconds;
+    std::size_t                         max_frame_count;
+    std::size_t                         max_buffer_bytes;
+    uint32_t                            poll_microseconds;
+    std::atomic<bool>                   running;
+};
+
+static const std::size_t MULTI_BATCH_COUNT = 256;
+
+static std::size_t get_shard_index(uint64_t stream_id, std::size_t shard_count)
+{
+    uint64_t value = stream_id;
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    return static_cast<std::size_t>(value % shard_count);
+}
+
+static void deliver_output(cm256_multi_decoder_t & decoder, multi_shard_t & shard)
+{
+    for (std::unordered_map<uint64_t, std::list<std::vector<uint8_t>>>::iterator iter = shard.output_map.begin(); shard.output_map.end() != iter; ++iter)
+    {
+        if (!iter->second.empty())
+        {
+            decoder.deliver(decoder.context, iter->first, iter->second);
+        }
+    }
+    shard.output_map.clear();
+}
+
+static void handle_message(cm256_multi_decoder_t & decoder, multi_shard_t & shard, multi_message_t & message)
+{
+    std::unordered_map<uint64_t, cm256_decoder_t *>::iterator iter = shard.stream_map.find(message.stream_id);
+
+    if (message.close)
+    {
+        if (shard.stream_map.end() != iter)
+        {
+            cm256_decoder_flush(iter->second, shard.output_map[message.stream_id]);
+            cm256_decoder_destroy(iter->second);
+            shard.stream_map.erase(iter);
+        }
+        return;
+    }
+
+    if (shard.stream_map.end() == iter)
+    {
+        cm256_decoder_t * stream = cm256_decoder_create(decoder.max_delay_microseconds, decoder.max_frame_count, decoder.max_buffer_bytes);
+        if (nullptr == stream)
+        {
+            return;
+        }
+        iter = shard.stream_map.insert(std::make_pair(message.stream_id, stream)).first;
+    }
+
+    cm256_decoder_decode(iter->second, &message.data[0], message.data.size(), shard.output_map[message.stream_id]);
+}
+
+static void poll_streams(multi_shard_t & shard)
+{
+    for (std::unordered_map<uint64_t, cm256_decoder_t *>::iterator iter = shard.stream_map.begin(); shard.stream_map.end() != iter; ++iter)
+    {
+        std::list<std::vector<uint8_t>> dst_data_list;
+        cm256_decoder_decode(iter->second, nullptr, 0, dst_data_list);
+        if (!dst_data_list.empty())
+        {
+            std::list<std::vector<uint8_t>> & output_list = shard.output_map[iter->first];
+            output_list.splice(output_list.end(), dst_data_list);
+        }
+    }
+}
+
+static void run_shard(cm256_multi_decoder_t * decoder, multi_shard_t * shard)
+{
+    typedef std::chrono::steady_clock clock_t;
+
+    const clock_t::duration poll_interval = std::chrono::microseconds(decoder->poll_microseconds);
+    clock_t::time_point next_poll = clock_t::now() + poll_interval;
+
+    while (true)
+    {
+        /* read before the queue is drained, once it is down every push is complete and an empty drain means the queue is done */
+        const bool running = decoder->running.load();
+
+        std::size_t count = 0;
+        multi_message_t * message = nullptr;
+        while (count < MULTI_BATCH_COUNT && nullptr != (message = shard->queue.pop()))
+        {
+            handle_message(*decoder, *shard, *message);
+            delete message;
+            ++count;
+        }
+
+        const clock_t::time_point now = clock_t::now();
+        if (now >= next_poll)
+        {
+            poll_streams(*shard);
+            next_poll = now + poll_interval;
+        }
+
+        deliver_output(*decoder, *shard);
+
+        if (0 != count)
+        {
+            continue;
+        }
+
+        if (!running)
+        {
+            break;
+        }
+
+        /* sleeping is raised before the last look at the queue, so a producer either sees it or its block is seen */
+        std::unique_lock<std::mutex> lock(shard->mutex);
+        shard->sleeping.store(true);
+        if (shard->queue.empty() && decoder->running.load())
+        {
+            shard->condition.wait_until(lock, next_poll);
+        }
+        shard->sleeping.store(false);
+    }
+
+    for (std::unordered_map<uint64_t, cm256_decoder_t *>::iterator iter = shard->stream_map.begin(); shard->stream_map.end() != iter; ++iter)
+    {
+        cm256_decoder_destroy(iter->second);
+    }
+    shard->stream_map.clear();
+}
+
+static void wake_shard(multi_shard_t & shard)
+{
+    if (shard.sleeping.load())
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.condition.notify_one();
+    }
+}
+
+cm256_multi_decoder_t * cm256_multi_decoder_create(std::size_t shard_count, cm256_multi_deliver_t deliver, void * context, uint32_t max_delay_microseconds, std::size_t max_frame_count, std::size_t max_buffer_bytes, uint32_t poll_microseconds)
+{
+    if (0 == shard_count || nullptr == deliver || 0 == max_frame_count || 0 == max_buffer_bytes || 0 == poll_microseconds)
+    {
+        return nullptr;
+    }
+
+    cm256_multi_decoder_t * decoder = new cm256_multi_decoder_t;
+    decoder->deliver = deliver;
+    decoder->context = context;
+    decoder->max_delay_microseconds = max_delay_microseconds;
+    decoder->max_frame_count = max_frame_count;
+    decoder->max_buffer_bytes = max_buffer_bytes;
+    decoder->poll_microseconds = poll_microseconds;
+    decoder->running.store(true);
+
+    for (std::size_t index = 0; index < shard_count; ++index)
+    {
+        decoder->shard_list.push_back(new multi_shard_t);
+    }
+    for (std::size_t index = 0; index < shard_count; ++index)
+    {
+        decoder->shard_list[index]->thread = std::thread(run_shard, decoder, decoder->shard_list[index]);
+    }
+
+    return decoder;
+}
+
+void cm256_multi_decoder_destroy(cm256_multi_decoder_t * decoder)
+{
+    if (nullptr == decoder)
+    {
+        return;
+    }
+
+    decoder->running.store(false);
+
+    for (std::size_t index = 0; index < decoder->shard_list.size(); ++index)
+    {
+        multi_shard_t * shard = decoder->shard_list[index];
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->condition.notify_one();
+        }
+        shard->thread.join();
+        delete shard;
+    }
+
+    delete decoder;
+}
+
+static bool push_message(cm256_multi_decoder_t * decoder, multi_message_t * message)
+{
+    multi_shard_t & shard = *decoder->shard_list[get_shard_index(message->stream_id, decoder->shard_list.size())];
+    shard.queue.push(message);
+    wake_shard(shard);
+    return true;
+}
+
+bool cm256_multi_decoder_push(cm256_multi_decoder_t * decoder, uint64_t stream_id, const void * data, std::size_t data_len)
+{
+    if (nullptr == decoder || nullptr == data || 0 == data_len)
+    {
+        return false;
+    }
+
+    multi_message_t * message = new multi_message_t;
+    message->stream_id = stream_id;
+    message->close = false;
+    message->data.assign(reinterpret_cast<const uint8_t *>(data), reinterpret_cast<const uint8_t *>(data) + data_len);
+    return push_message(decoder, message);
+}
+
+bool cm256_multi_decoder_close(cm256_multi_decoder_t * decoder, uint64_t stream_id)
+{
+    if (nullptr == decoder)
+    {
+        return false;
+    }
+
+    multi_message_t * message = new multi_message_t;
+    message->stream_id = stream_id;
+    message->close = true;
+    return push_message(decoder, message);
+}
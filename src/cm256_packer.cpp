@@ -0,0 +1,191 @@
+/********************************************************
+ * Description : cm256 message packer
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#ifdef _MSC_VER
+#include <winsock2.h>
+#else
+#include <arpa/inet.h>
+#endif // _MSC_VER
+
+#include <cstring>
+
+#include "cm256_packer.h"
+
+#pragma pack(push, 1)
+
+struct pack_header_t
+{
+    uint32_t            sequence;
+};
+
+struct pack_record_t
+{
+    uint16_t            record_bytes;
+    uint8_t             record_flags;
+};
+
+#pragma pack(pop)
+
+static const uint8_t PACK_MESSAGE_BEGIN = 0x01;
+static const uint8_t PACK_MESSAGE_END = 0x02;
+
+packer_t::packer_t()
+    : sequence(0)
+    , block()
+{
+}
+
+unpacker_t::unpacker_t()
+    : started(false)
+    , sequence(0)
+    , assembling(false)
+    , skipping(false)
+    , message()
+    , dropped_count(0)
+{
+}
+
+static void emit_block(packer_t & packer, std::list<std::vector<uint8_t>> & dst_block_list)
+{
+    dst_block_list.emplace_back(std::vector<uint8_t>());
+    dst_block_list.back().swap(packer.block);
+}
+
+bool cm256_pack(const void * data, std::size_t data_len, packer_t & packer, std::list<std::vector<uint8_t>> & dst_block_list, std::size_t block_bytes)
+{
+    if (nullptr == data || 0 == data_len || block_bytes <= sizeof(pack_header_t) + sizeof(pack_record_t) || block_bytes > 65535)
+    {
+        return false;
+    }
+
+    const uint8_t * fragment = reinterpret_cast<const uint8_t *>(data);
+    std::size_t remain_bytes = data_len;
+    uint8_t record_flags = PACK_MESSAGE_BEGIN;
+
+    while (0 != remain_bytes)
+    {
+        if (packer.block.empty())
+        {
+            packer.block.reserve(block_bytes);
+            pack_header_t header = { htonl(packer.sequence++) };
+            packer.block.insert(packer.block.end(), reinterpret_cast<const uint8_t *>(&header), reinterpret_cast<const uint8_t *>(&header) + sizeof(header));
+        }
+
+        const std::size_t space_bytes = block_bytes - packer.block.size();
+        const std::size_t record_bytes = (remain_bytes < space_bytes - sizeof(pack_record_t) ? remain_bytes : space_bytes - sizeof(pack_record_t));
+        if (record_bytes == remain_bytes)
+        {
+            record_flags |= PACK_MESSAGE_END;
+        }
+
+        pack_record_t record = { htons(static_cast<uint16_t>(record_bytes)), record_flags };
+        packer.block.insert(packer.block.end(), reinterpret_cast<const uint8_t *>(&record), reinterpret_cast<const uint8_t *>(&record) + sizeof(record));
+        packer.block.insert(packer.block.end(), fragment, fragment + record_bytes);
+
+        fragment += record_bytes;
+        remain_bytes -= record_bytes;
+        record_flags = 0;
+
+        /* a block without room for one more byte of payload is done */
+        if (packer.block.size() + sizeof(pack_record_t) >= block_bytes)
+        {
+            emit_block(packer, dst_block_list);
+        }
+    }
+
+    return true;
+}
+
+bool cm256_pack_flush(packer_t & packer, std::list<std::vector<uint8_t>> & dst_block_list)
+{
+    if (!packer.block.empty())
+    {
+        emit_block(packer, dst_block_list);
+    }
+    return true;
+}
+
+static void drop_message(unpacker_t & unpacker)
+{
+    if (unpacker.assembling)
+    {
+        ++unpacker.dropped_count;
+        unpacker.assembling = false;
+        unpacker.skipping = true;
+    }
+    unpacker.message.clear();
+}
+
+bool cm256_unpack(const void * data, std::size_t data_len, unpacker_t & unpacker, std::list<std::vector<uint8_t>> & dst_message_list)
+{
+    if (nullptr == data || data_len < sizeof(pack_header_t))
+    {
+        return false;
+    }
+
+    const uint8_t * block = reinterpret_cast<const uint8_t *>(data);
+    const uint32_t sequence = ntohl(reinterpret_cast<const pack_header_t *>(block)->sequence);
+
+    if (unpacker.started && sequence != unpacker.sequence)
+    {
+        if (static_cast<int32_t>(sequence - unpacker.sequence) < 0)
+        {
+            return false;
+        }
+        drop_message(unpacker);
+    }
+
+    unpacker.started = true;
+    unpacker.sequence = sequence + 1;
+
+    std::size_t offset = sizeof(pack_header_t);
+    while (offset + sizeof(pack_record_t) <= data_len)
+    {
+        const pack_record_t * record = reinterpret_cast<const pack_record_t *>(block + offset);
+        const std::size_t record_bytes = ntohs(record->record_bytes);
+        offset += sizeof(pack_record_t);
+        if (offset + record_bytes > data_len)
+        {
+            drop_message(unpacker);
+            return false;
+        }
+
+        if (0 != (record->record_flags & PACK_MESSAGE_BEGIN))
+        {
+            drop_message(unpacker);
+            unpacker.assembling = true;
+            unpacker.skipping = false;
+        }
+        else if (!unpacker.assembling && !unpacker.skipping)
+        {
+            /* the tail of a message whose head was lost */
+            ++unpacker.dropped_count;
+            unpacker.skipping = true;
+        }
+
+        if (unpacker.assembling)
+        {
+            unpacker.message.insert(unpacker.message.end(), block + offset, block + offset + record_bytes);
+            if (0 != (record->record_flags & PACK_MESSAGE_END))
+            {
+                dst_message_list.emplace_back(std::vector<uint8_t>());
+                dst_message_list.back().swap(unpacker.message);
+                unpacker.assembling = false;
+            }
+        }
+        else if (0 != (record->record_flags & PACK_MESSAGE_END))
+        {
+            unpacker.skipping = false;
+        }
+
+        offset += record_bytes;
+    }
+
+    return true;
+}
@@ -0,0 +1,376 @@
+/********************************************************
+ * Description : cm256 encode and send pipeline
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "cm256_pipeline.h"
+
+/*
+ * bounded spsc ring (Lamport): the producer owns the tail, the consumer owns the head, each keeps
+ * a copy of the other's index and only reloads it when the ring looks full or empty, items are
+ * swapped in and out so a slot keeps its buffer for the next block
+ */
+template <typename T>
+class spsc_ring_t
+{
+public:
+    explicit spsc_ring_t(std::size_t capacity)
+        : m_slots()
+        , m_mask(0)
+        , m_head(0)
+        , m_tail_cache(0)
+        , m_tail(0)
+        , m_head_cache(0)
+    {
+        std::size_t slot_count = 1;
+        while (slot_count < capacity)
+        {
+            slot_count <<= 1;
+        }
+        m_slots.resize(slot_count);
+        m_mask = slot_count - 1;
+    }
+
+    bool push(T & item)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head_cache > m_mask)
+        {
+            m_head_cache = m_head.load(std::memory_order_acquire);
+            if (tail - m_head_cache > m_mask)
+            {
+                return false;
+            }
+        }
+        m_slots[tail & m_mask].swap(item);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T & item)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail_cache)
+        {
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tail_cache)
+            {
+                return false;
+            }
+        }
+        item.swap(m_slots[head & m_mask]);
+        m_slots[head & m_mask].clear();
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /* for the waiting side only, either answer may be stale by the time it is used */
+    bool empty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+    bool full() const
+    {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire) > m_mask;
+    }
+
+private:
+    std::vector<T>                      m_slots;
+    std::size_t                         m_mask;
+    /* consumer side and producer side sit on separate cache lines */
+    char                                m_pad0[64];
+    std::atomic<std::size_t>            m_head;
+    std::size_t                         m_tail_cache;
+    char                                m_pad1[64];
+    std::atomic<std::size_t>            m_tail;
+    std::size_t                         m_head_cache;
+    char                                m_pad2[64];
+};
+
+typedef spsc_ring_t<std::vector<uint8_t>> pipeline_ring_t;
+
+/* a thread that found nothing to do parks here, sleeping lets the others skip the lock when it is busy */
+struct pipeline_signal_t
+{
+    std::atomic<bool>                   sleeping;
+    std::mutex                          mutex;
+    std::condition_variable             condition;
+
+    pipeline_signal_t()
+        : sleeping(false)
+        , mutex()
+        , condition()
+    {
+    }
+};
+
+struct cm256_pipeline_t
+{
+    cm256_pipeline_send_t               send;
+    void                              * context;
+    double                              recovery_rate;
+    std::size_t                         max_data_size;
+    std::size_t                         max_original_count;
+    uint32_t                            max_delay_microseconds;
+    bool                                recovery_force;
+    std::size_t                         max_batch_count;
+    stream_encoder_t                    encoder;
+    pipeline_ring_t                     input_ring;
+    pipeline_ring_t                     output_ring;
+    pipeline_signal_t                   producer_signal;
+    pipeline_signal_t                   encoder_signal;
+    pipeline_signal_t                   sender_signal;
+    uint64_t                            flush_requested;
+    std::atomic<uint64_t>               flush_completed;
+    std::atomic<bool>                   encoding;
+    std::atomic<bool>                   sending;
+    std::thread                         encoder_thread;
+    std::thread                         sender_thread;
+
+    explicit cm256_pipeline_t(std::size_t queue_block_count)
+        : send(nullptr)
+        , context(nullptr)
+        , recovery_rate(0.0)
+        , max_data_size(0)
+        , max_original_count(0)
+        , max_delay_microseconds(0)
+        , recovery_force(false)
+        , max_batch_count(0)
+        , encoder()
+        , input_ring(queue_block_count)
+        , output_ring(queue_block_count)
+        , producer_signal()
+        , encoder_signal()
+        , sender_signal()
+        , flush_requested(0)
+        , flush_completed(0)
+        , encoding(true)
+        , sending(true)
+        , encoder_thread()
+        , sender_thread()
+    {
+    }
+};
+
+/* longest idle wait, so the encoder looks at the open frame's deadline even when nothing is pushed */
+static const uint32_t PIPELINE_POLL_MICROSECONDS = 1000;
+
+static void wake_signal(pipeline_signal_t & signal)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (signal.sleeping.load())
+    {
+        std::lock_guard<std::mutex> lock(signal.mutex);
+        signal.condition.notify_one();
+    }
+}
+
+/* sleeping is raised before the last look at the rings, so a waker either sees it or its work is seen */
+template <typename Ready>
+static void wait_signal(pipeline_signal_t & signal, Ready ready)
+{
+    std::unique_lock<std::mutex> lock(signal.mutex);
+    signal.sleeping.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!ready())
+    {
+        signal.condition.wait_for(lock, std::chrono::microseconds(PIPELINE_POLL_MICROSECONDS));
+    }
+    signal.sleeping.store(false);
+}
+
+static void forward_blocks(cm256_pipeline_t & pipeline, std::list<std::vector<uint8_t>> & block_list)
+{
+    for (std::list<std::vector<uint8_t>>::iterator iter = block_list.begin(); block_list.end() != iter; ++iter)
+    {
+        while (!pipeline.output_ring.push(*iter))
+        {
+            wake_signal(pipeline.sender_signal);
+            wait_signal(pipeline.encoder_signal, [&pipeline]() { return !pipeline.output_ring.full(); });
+        }
+    }
+    block_list.clear();
+    wake_signal(pipeline.sender_signal);
+}
+
+static void run_encoder(cm256_pipeline_t * pipeline)
+{
+    std::vector<uint8_t> payload;
+    std::list<std::vector<uint8_t>> block_list;
+
+    while (true)
+    {
+        if (pipeline->input_ring.pop(payload))
+        {
+            wake_signal(pipeline->producer_signal);
+            /* the flush marker closes the open frame and follows its blocks into the output ring */
+            if (payload.empty())
+            {
+                cm256_stream_flush(pipeline->encoder, block_list);
+                block_list.push_back(std::vector<uint8_t>());
+            }
+            else
+            {
+                cm256_stream_encode(&payload[0], payload.size(), pipeline->encoder, block_list, pipeline->recovery_rate, pipeline->max_data_size, pipeline->max_original_count, pipeline->max_delay_microseconds, pipeline->recovery_force);
+            }
+            forward_blocks(*pipeline, block_list);
+            continue;
+        }
+
+        /* idle, so the open frame's deadline is due for a look */
+        cm256_stream_encode(nullptr, 0, pipeline->encoder, block_list, pipeline->recovery_rate, pipeline->max_data_size, pipeline->max_original_count, pipeline->max_delay_microseconds, pipeline->recovery_force);
+        if (!block_list.empty())
+        {
+            forward_blocks(*pipeline, block_list);
+        }
+
+        if (!pipeline->encoding.load() && pipeline->input_ring.empty())
+        {
+            break;
+        }
+
+        wait_signal(pipeline->encoder_signal, [pipeline]() { return !pipeline->input_ring.empty() || !pipeline->encoding.load(); });
+    }
+}
+
+static void run_sender(cm256_pipeline_t * pipeline)
+{
+    std::vector<uint8_t> block;
+    std::list<std::vector<uint8_t>> batch_list;
+    uint64_t flush_count = 0;
+
+    while (true)
+    {
+        while (batch_list.size() < pipeline->max_batch_count && 0 == flush_count && pipeline->output_ring.pop(block))
+        {
+            if (block.empty())
+            {
+                ++flush_count;
+            }
+            else
+            {
+                batch_list.push_back(std::vector<uint8_t>());
+                batch_list.back().swap(block);
+            }
+        }
+
+        if (!batch_list.empty() || 0 != flush_count)
+        {
+            wake_signal(pipeline->encoder_signal);
+            if (!batch_list.empty())
+            {
+                pipeline->send(pipeline->context, batch_list);
+                batch_list.clear();
+            }
+            if (0 != flush_count)
+            {
+                pipeline->flush_completed.fetch_add(flush_count);
+                flush_count = 0;
+                wake_signal(pipeline->producer_signal);
+            }
+            continue;
+        }
+
+        if (!pipeline->sending.load() && pipeline->output_ring.empty())
+        {
+            break;
+        }
+
+        wait_signal(pipeline->sender_signal, [pipeline]() { return !pipeline->output_ring.empty() || !pipeline->sending.load(); });
+    }
+}
+
+cm256_pipeline_t * cm256_pipeline_create(cm256_pipeline_send_t send, void * context, double recovery_rate, std::size_t max_data_size, std::size_t max_original_count, uint32_t max_delay_microseconds, bool recovery_force, std::size_t queue_block_count, std::size_t max_batch_count)
+{
+    if (nullptr == send || 0 == max_data_size || max_data_size >= 65536 || 0 == queue_block_count || 0 == max_batch_count)
+    {
+        return nullptr;
+    }
+
+    cm256_pipeline_t * pipeline = new cm256_pipeline_t(queue_block_count);
+    pipeline->send = send;
+    pipeline->context = context;
+    pipeline->recovery_rate = recovery_rate;
+    pipeline->max_data_size = max_data_size;
+    pipeline->max_original_count = max_original_count;
+    pipeline->max_delay_microseconds = max_delay_microseconds;
+    pipeline->recovery_force = recovery_force;
+    pipeline->max_batch_count = max_batch_count;
+    pipeline->sender_thread = std::thread(run_sender, pipeline);
+    pipeline->encoder_thread = std::thread(run_encoder, pipeline);
+
+    return pipeline;
+}
+
+static void push_payload(cm256_pipeline_t & pipeline, std::vector<uint8_t> & payload)
+{
+    while (!pipeline.input_ring.push(payload))
+    {
+        wake_signal(pipeline.encoder_signal);
+        wait_signal(pipeline.producer_signal, [&pipeline]() { return !pipeline.input_ring.full(); });
+    }
+    wake_signal(pipeline.encoder_signal);
+}
+
+bool cm256_pipeline_push(cm256_pipeline_t * pipeline, const void * data, std::size_t data_len)
+{
+    if (nullptr == pipeline || nullptr == data || 0 == data_len || data_len > pipeline->max_data_size)
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> payload(reinterpret_cast<const uint8_t *>(data), reinterpret_cast<const uint8_t *>(data) + data_len);
+    push_payload(*pipeline, payload);
+    return true;
+}
+
+bool cm256_pipeline_flush(cm256_pipeline_t * pipeline)
+{
+    if (nullptr == pipeline)
+    {
+        return false;
+    }
+
+    /* an empty entry in either ring is a flush marker, pushed payloads are never empty */
+    const uint64_t flush_ticket = ++pipeline->flush_requested;
+    std::vector<uint8_t> marker;
+    push_payload(*pipeline, marker);
+
+    while (pipeline->flush_completed.load() < flush_ticket)
+    {
+        wait_signal(pipeline->producer_signal, [pipeline, flush_ticket]() { return pipeline->flush_completed.load() >= flush_ticket; });
+    }
+
+    return true;
+}
+
+void cm256_pipeline_destroy(cm256_pipeline_t * pipeline)
+{
+    if (nullptr == pipeline)
+    {
+        return;
+    }
+
+    cm256_pipeline_flush(pipeline);
+
+    pipeline->encoding.store(false);
+    wake_signal(pipeline->encoder_signal);
+    pipeline->encoder_thread.join();
+
+    pipeline->sending.store(false);
+    wake_signal(pipeline->sender_signal);
+    pipeline->sender_thread.join();
+
+    delete pipeline;
+}
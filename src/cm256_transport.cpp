@@ -0,0 +1,605 @@
+/********************************************************
+ * Description : cm256 udp transport
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#ifdef _MSC_VER
+#include <winsock2.h>
+#else
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#endif // _MSC_VER
+
+#include <cstring>
+
+#include "cm256_transport.h"
+#include "cm256_uring.h"
+
+#if defined(__linux__) && defined(UDP_SEGMENT)
+    #define CM256_TRANSPORT_GSO
+#endif // __linux__ && UDP_SEGMENT
+
+struct cm256_transport_t
+{
+    cm256_socket_t                      sock;
+    std::size_t                         max_batch_count;
+    std::size_t                         max_datagram_bytes;
+    bool                                use_gso;
+    std::vector<uint8_t>                recv_buffer;
+#ifdef __linux__
+    std::vector<struct mmsghdr>         msg_list;
+    std::vector<struct iovec>           iov_list;
+#endif // __linux__
+#ifdef CM256_TRANSPORT_URING
+    uring_t                           * uring;
+    std::size_t                         slot_bytes;
+    std::vector<uint8_t>                send_buffer;
+    bool                                recv_posted;
+    bool                                recv_timed_out;
+    std::vector<std::pair<std::size_t, int>>    recv_ready_list;
+    struct __kernel_timespec            recv_timeout;
+#endif // CM256_TRANSPORT_URING
+};
+
+/* a gso send carries at most this many segments and stays within one ip datagram */
+static const std::size_t GSO_MAX_SEGMENTS = 64;
+static const std::size_t GSO_MAX_BYTES = 65000;
+
+#ifdef CM256_TRANSPORT_URING
+
+/* user_data of a completion: what the operation was in the high word, its slot in the low word */
+static const uint64_t URING_RECV_TAG = 1ULL << 32;
+static const uint64_t URING_SEND_TAG = 2ULL << 32;
+static const uint64_t URING_TIMEOUT_TAG = 3ULL << 32;
+static const uint64_t URING_SLOT_MASK = 0xFFFFFFFFULL;
+
+static bool create_uring(cm256_transport_t & transport)
+{
+    /* one spare byte per slot tells a datagram that filled the slot from one that did not fit */
+    transport.slot_bytes = transport.max_datagram_bytes + 1;
+    transport.recv_buffer.resize(transport.max_batch_count * transport.slot_bytes);
+    transport.send_buffer.resize(transport.max_batch_count * transport.slot_bytes);
+
+    struct iovec buffers[2];
+    buffers[0].iov_base = &transport.recv_buffer[0];
+    buffers[0].iov_len = transport.recv_buffer.size();
+    buffers[1].iov_base = &transport.send_buffer[0];
+    buffers[1].iov_len = transport.send_buffer.size();
+
+    /* every slot may have a read and a write in flight, plus one timeout */
+    transport.uring = new uring_t;
+    if (!transport.uring->create(static_cast<unsigned>(transport.max_batch_count * 2 + 1), buffers, 2))
+    {
+        delete transport.uring;
+        transport.uring = nullptr;
+        std::vector<uint8_t>().swap(transport.recv_buffer);
+        std::vector<uint8_t>().swap(transport.send_buffer);
+        return false;
+    }
+
+    return true;
+}
+
+#endif // CM256_TRANSPORT_URING
+
+cm256_transport_t * cm256_transport_create(cm256_socket_t sock, std::size_t max_batch_count, std::size_t max_datagram_bytes, bool use_gso, bool use_uring)
+{
+    if (0 == max_batch_count || 0 == max_datagram_bytes)
+    {
+        return nullptr;
+    }
+
+    cm256_transport_t * transport = new cm256_transport_t;
+    transport->sock = sock;
+    transport->max_batch_count = max_batch_count;
+    transport->max_datagram_bytes = max_datagram_bytes;
+#ifdef CM256_TRANSPORT_GSO
+    transport->use_gso = use_gso;
+#else
+    transport->use_gso = false;
+    (void)use_gso;
+#endif // CM256_TRANSPORT_GSO
+#ifdef CM256_TRANSPORT_URING
+    transport->uring = nullptr;
+    transport->slot_bytes = 0;
+    transport->recv_posted = false;
+    transport->recv_timed_out = false;
+    memset(&transport->recv_timeout, 0x0, sizeof(transport->recv_timeout));
+    if (use_uring && max_batch_count <= URING_SLOT_MASK)
+    {
+        /* a kernel without io_uring, or one that refuses it, leaves the socket path in place */
+        create_uring(*transport);
+    }
+#else
+    (void)use_uring;
+#endif // CM256_TRANSPORT_URING
+    return transport;
+}
+
+void cm256_transport_destroy(cm256_transport_t * transport)
+{
+    if (nullptr == transport)
+    {
+        return;
+    }
+
+#ifdef CM256_TRANSPORT_URING
+    /* closing the ring cancels the reads still posted, the registered pages stay pinned until they are gone */
+    delete transport->uring;
+#endif // CM256_TRANSPORT_URING
+    delete transport;
+}
+
+bool cm256_transport_uses_uring(const cm256_transport_t * transport)
+{
+#ifdef CM256_TRANSPORT_URING
+    return nullptr != transport && nullptr != transport->uring;
+#else
+    (void)transport;
+    return false;
+#endif // CM256_TRANSPORT_URING
+}
+
+#ifdef __linux__
+
+struct gso_control_t
+{
+    union
+    {
+        char                            buffer[CMSG_SPACE(sizeof(uint16_t))];
+        struct cmsghdr                  align;
+    };
+};
+
+/* sends the prepared messages, msg_index tells how many went out when it fails */
+static bool send_messages(cm256_transport_t & transport, std::size_t & msg_index)
+{
+    const std::size_t msg_count = transport.msg_list.size();
+    msg_index = 0;
+    while (msg_index < msg_count)
+    {
+        const int ret = sendmmsg(transport.sock, &transport.msg_list[msg_index], static_cast<unsigned int>(msg_count - msg_index), 0);
+        if (ret < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            return false;
+        }
+        msg_index += static_cast<std::size_t>(ret);
+    }
+    return true;
+}
+
+static bool send_batch(cm256_transport_t & transport, std::list<std::vector<uint8_t>>::const_iterator begin, std::list<std::vector<uint8_t>>::const_iterator end, std::vector<gso_control_t> & control_list, std::size_t & sent_count)
+{
+    transport.msg_list.clear();
+    transport.iov_list.clear();
+    control_list.clear();
+
+    /* the iovecs are laid out first, the messages point into them once the vector stops moving */
+    std::vector<std::pair<std::size_t, std::size_t>> range_list;
+    std::vector<uint16_t> segment_list;
+
+    std::list<std::vector<uint8_t>>::const_iterator iter = begin;
+    while (end != iter && range_list.size() < transport.max_batch_count)
+    {
+        const std::size_t iov_begin = transport.iov_list.size();
+        const std::size_t segment_bytes = iter->size();
+        std::size_t total_bytes = 0;
+        do
+        {
+            struct iovec iov;
+            iov.iov_base = const_cast<uint8_t *>(iter->data());
+            iov.iov_len = iter->size();
+            transport.iov_list.push_back(iov);
+            total_bytes += iter->size();
+            ++iter;
+        } while (transport.use_gso && end != iter && transport.iov_list.back().iov_len == segment_bytes && iter->size() <= segment_bytes && 
+            transport.iov_list.size() - iov_begin < GSO_MAX_SEGMENTS && total_bytes + iter->size() <= GSO_MAX_BYTES);
+        range_list.push_back(std::make_pair(iov_begin, transport.iov_list.size() - iov_begin));
+        segment_list.push_back(static_cast<uint16_t>(segment_bytes));
+    }
+
+    transport.msg_list.resize(range_list.size());
+    control_list.resize(range_list.size());
+    for (std::size_t msg_index = 0; msg_index < range_list.size(); ++msg_index)
+    {
+        struct msghdr & msg = transport.msg_list[msg_index].msg_hdr;
+        memset(&transport.msg_list[msg_index], 0x0, sizeof(transport.msg_list[msg_index]));
+        msg.msg_iov = &transport.iov_list[range_list[msg_index].first];
+        msg.msg_iovlen = range_list[msg_index].second;
+#ifdef CM256_TRANSPORT_GSO
+        if (range_list[msg_index].second > 1)
+        {
+            memset(&control_list[msg_index], 0x0, sizeof(control_list[msg_index]));
+            msg.msg_control = control_list[msg_index].buffer;
+            msg.msg_controllen = sizeof(control_list[msg_index].buffer);
+            struct cmsghdr * cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            memcpy(CMSG_DATA(cmsg), &segment_list[msg_index], sizeof(uint16_t));
+        }
+#endif // CM256_TRANSPORT_GSO
+    }
+
+    std::size_t msg_index = 0;
+    const bool ret = send_messages(transport, msg_index);
+
+    sent_count = 0;
+    for (std::size_t index = 0; index < msg_index; ++index)
+    {
+        sent_count += range_list[index].second;
+    }
+
+    return ret;
+}
+
+#ifdef CM256_TRANSPORT_URING
+
+/* takes every completion out of the ring, reads are kept for the next receive, writes are counted */
+static bool reap_uring(cm256_transport_t & transport, std::size_t & send_count)
+{
+    bool ret = true;
+    uint64_t user_data = 0;
+    int result = 0;
+    while (transport.uring->pop_cqe(user_data, result))
+    {
+        const uint64_t tag = (user_data & ~URING_SLOT_MASK);
+        if (URING_RECV_TAG == tag)
+        {
+            transport.recv_ready_list.push_back(std::make_pair(static_cast<std::size_t>(user_data & URING_SLOT_MASK), result));
+        }
+        else if (URING_SEND_TAG == tag)
+        {
+            /* a write that failed cancels the ones linked after it, all of them come back here */
+            if (result < 0)
+            {
+                errno = -result;
+                ret = false;
+            }
+            ++send_count;
+        }
+        else if (URING_TIMEOUT_TAG == tag)
+        {
+            transport.recv_timed_out = (-ETIME == result);
+        }
+    }
+    return ret;
+}
+
+static bool uring_send(cm256_transport_t & transport, std::list<std::vector<uint8_t>>::const_iterator begin, std::list<std::vector<uint8_t>>::const_iterator end)
+{
+    while (end != begin)
+    {
+        /* the writes of a batch are linked, so the datagrams leave in list order */
+        std::size_t slot = 0;
+        struct io_uring_sqe * prev_sqe = nullptr;
+        for (; end != begin && slot < transport.max_batch_count; ++begin, ++slot)
+        {
+            uint8_t * slot_data = &transport.send_buffer[slot * transport.slot_bytes];
+            memcpy(slot_data, begin->data(), begin->size());
+
+            struct io_uring_sqe * sqe = transport.uring->get_sqe();
+            if (nullptr == sqe)
+            {
+                errno = EBUSY;
+                return false;
+            }
+            sqe->opcode = IORING_OP_WRITE_FIXED;
+            sqe->fd = transport.sock;
+            sqe->addr = reinterpret_cast<uint64_t>(slot_data);
+            sqe->len = static_cast<uint32_t>(begin->size());
+            sqe->buf_index = 1;
+            sqe->user_data = URING_SEND_TAG | slot;
+            if (nullptr != prev_sqe)
+            {
+                prev_sqe->flags |= IOSQE_IO_LINK;
+            }
+            prev_sqe = sqe;
+        }
+
+        bool ret = true;
+        std::size_t send_count = 0;
+        while (send_count < slot)
+        {
+            const int error = transport.uring->enter(1);
+            if (error < 0)
+            {
+                errno = -error;
+                return false;
+            }
+            ret = reap_uring(transport, send_count) && ret;
+        }
+        if (!ret)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool uring_post_recv(cm256_transport_t & transport, std::size_t slot)
+{
+    struct io_uring_sqe * sqe = transport.uring->get_sqe();
+    if (nullptr == sqe)
+    {
+        return false;
+    }
+    sqe->opcode = IORING_OP_READ_FIXED;
+    sqe->fd = transport.sock;
+    sqe->addr = reinterpret_cast<uint64_t>(&transport.recv_buffer[slot * transport.slot_bytes]);
+    sqe->len = static_cast<uint32_t>(transport.slot_bytes);
+    sqe->buf_index = 0;
+    sqe->user_data = URING_RECV_TAG | slot;
+    return true;
+}
+
+static bool uring_wait_recv(cm256_transport_t & transport)
+{
+    /* the socket's own receive timeout bounds the wait, as it does for recvmmsg */
+    struct timeval timeout;
+    socklen_t timeout_len = sizeof(timeout);
+    memset(&timeout, 0x0, sizeof(timeout));
+    getsockopt(transport.sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, &timeout_len);
+    transport.recv_timed_out = false;
+    if (0 != timeout.tv_sec || 0 != timeout.tv_usec)
+    {
+        struct io_uring_sqe * sqe = transport.uring->get_sqe();
+        if (nullptr == sqe)
+        {
+            errno = EBUSY;
+            return false;
+        }
+        transport.recv_timeout.tv_sec = timeout.tv_sec;
+        transport.recv_timeout.tv_nsec = timeout.tv_usec * 1000;
+        sqe->opcode = IORING_OP_TIMEOUT;
+        sqe->addr = reinterpret_cast<uint64_t>(&transport.recv_timeout);
+        sqe->len = 1;
+        sqe->off = 1;
+        sqe->user_data = URING_TIMEOUT_TAG;
+    }
+
+    while (transport.recv_ready_list.empty())
+    {
+        const int error = transport.uring->enter(1);
+        if (error < 0)
+        {
+            errno = -error;
+            return false;
+        }
+        std::size_t send_count = 0;
+        reap_uring(transport, send_count);
+        if (transport.recv_ready_list.empty() && transport.recv_timed_out)
+        {
+            errno = EAGAIN;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool uring_receive(cm256_transport_t & transport, std::list<std::vector<uint8_t>> & data_list)
+{
+    if (!transport.recv_posted)
+    {
+        for (std::size_t slot = 0; slot < transport.max_batch_count; ++slot)
+        {
+            if (!uring_post_recv(transport, slot))
+            {
+                errno = EBUSY;
+                return false;
+            }
+        }
+        transport.recv_posted = true;
+    }
+
+    std::size_t send_count = 0;
+    reap_uring(transport, send_count);
+    if (transport.recv_ready_list.empty() && !uring_wait_recv(transport))
+    {
+        return false;
+    }
+
+    for (std::size_t index = 0; index < transport.recv_ready_list.size(); ++index)
+    {
+        const std::size_t slot = transport.recv_ready_list[index].first;
+        const int result = transport.recv_ready_list[index].second;
+        /* a datagram that reached the spare byte did not fit, an error just rearms the slot */
+        if (result > 0 && static_cast<std::size_t>(result) <= transport.max_datagram_bytes)
+        {
+            const uint8_t * data = &transport.recv_buffer[slot * transport.slot_bytes];
+            data_list.emplace_back(std::vector<uint8_t>(data, data + result));
+        }
+        uring_post_recv(transport, slot);
+    }
+    transport.recv_ready_list.clear();
+
+    const int error = transport.uring->enter(0);
+    if (error < 0)
+    {
+        errno = -error;
+        return false;
+    }
+
+    return true;
+}
+
+#endif // CM256_TRANSPORT_URING
+
+bool cm256_transport_send(cm256_transport_t * transport, const std::list<std::vector<uint8_t>> & data_list)
+{
+    if (nullptr == transport)
+    {
+        return false;
+    }
+
+#ifdef CM256_TRANSPORT_URING
+    if (nullptr != transport->uring)
+    {
+        /* a block larger than a slot cannot go through the registered buffer, the list takes the socket path */
+        bool fit = true;
+        for (std::list<std::vector<uint8_t>>::const_iterator iter = data_list.begin(); data_list.end() != iter && fit; ++iter)
+        {
+            fit = iter->size() <= transport->max_datagram_bytes;
+        }
+        if (fit)
+        {
+            return uring_send(*transport, data_list.begin(), data_list.end());
+        }
+    }
+#endif // CM256_TRANSPORT_URING
+
+    std::vector<gso_control_t> control_list;
+    std::list<std::vector<uint8_t>>::const_iterator begin = data_list.begin();
+    while (data_list.end() != begin)
+    {
+        /* a batch holds at most max_batch_count * GSO_MAX_SEGMENTS blocks, find where it ends before sending */
+        std::list<std::vector<uint8_t>>::const_iterator end = begin;
+        for (std::size_t count = 0; data_list.end() != end && count < transport->max_batch_count * (transport->use_gso ? GSO_MAX_SEGMENTS : 1); ++count)
+        {
+            ++end;
+        }
+
+        /* send_batch stops at max_batch_count messages, so it may take fewer blocks than offered */
+        std::size_t sent_count = 0;
+        const bool ret = send_batch(*transport, begin, end, control_list, sent_count);
+        std::advance(begin, sent_count);
+
+        if (!ret)
+        {
+            /* a kernel or device without udp gso refuses the cmsg, the rest goes one datagram each */
+            if (!transport->use_gso || (EIO != errno && EINVAL != errno && ENOPROTOOPT != errno))
+            {
+                return false;
+            }
+            transport->use_gso = false;
+        }
+    }
+
+    return true;
+}
+
+bool cm256_transport_receive(cm256_transport_t * transport, std::list<std::vector<uint8_t>> & data_list)
+{
+    if (nullptr == transport)
+    {
+        return false;
+    }
+
+#ifdef CM256_TRANSPORT_URING
+    if (nullptr != transport->uring)
+    {
+        return uring_receive(*transport, data_list);
+    }
+#endif // CM256_TRANSPORT_URING
+
+    const std::size_t batch_count = transport->max_batch_count;
+    transport->recv_buffer.resize(batch_count * transport->max_datagram_bytes);
+    transport->msg_list.resize(batch_count);
+    transport->iov_list.resize(batch_count);
+    for (std::size_t msg_index = 0; msg_index < batch_count; ++msg_index)
+    {
+        transport->iov_list[msg_index].iov_base = &transport->recv_buffer[msg_index * transport->max_datagram_bytes];
+        transport->iov_list[msg_index].iov_len = transport->max_datagram_bytes;
+        memset(&transport->msg_list[msg_index], 0x0, sizeof(transport->msg_list[msg_index]));
+        transport->msg_list[msg_index].msg_hdr.msg_iov = &transport->iov_list[msg_index];
+        transport->msg_list[msg_index].msg_hdr.msg_iovlen = 1;
+    }
+
+    int ret = 0;
+    do
+    {
+        ret = recvmmsg(transport->sock, &transport->msg_list[0], static_cast<unsigned int>(batch_count), MSG_WAITFORONE, nullptr);
+    } while (ret < 0 && EINTR == errno);
+
+    if (ret < 0)
+    {
+        return false;
+    }
+
+    for (int msg_index = 0; msg_index < ret; ++msg_index)
+    {
+        /* a truncated datagram cannot be a block of ours */
+        if (0 != (transport->msg_list[msg_index].msg_hdr.msg_flags & MSG_TRUNC))
+        {
+            continue;
+        }
+        const uint8_t * data = reinterpret_cast<const uint8_t *>(transport->iov_list[msg_index].iov_base);
+        data_list.emplace_back(std::vector<uint8_t>(data, data + transport->msg_list[msg_index].msg_len));
+    }
+
+    return true;
+}
+
+#else
+
+bool cm256_transport_send(cm256_transport_t * transport, const std::list<std::vector<uint8_t>> & data_list)
+{
+    if (nullptr == transport)
+    {
+        return false;
+    }
+
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = data_list.begin(); data_list.end() != iter; ++iter)
+    {
+        if (send(transport->sock, reinterpret_cast<const char *>(iter->data()), static_cast<int>(iter->size()), 0) < 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool cm256_transport_receive(cm256_transport_t * transport, std::list<std::vector<uint8_t>> & data_list)
+{
+    if (nullptr == transport)
+    {
+        return false;
+    }
+
+    transport->recv_buffer.resize(transport->max_datagram_bytes);
+    const int ret = recv(transport->sock, reinterpret_cast<char *>(&transport->recv_buffer[0]), static_cast<int>(transport->recv_buffer.size()), 0);
+    if (ret < 0)
+    {
+        return false;
+    }
+
+    data_list.emplace_back(std::vector<uint8_t>(transport->recv_buffer.begin(), transport->recv_buffer.begin() + ret));
+    return true;
+}
+
+#endif // __linux__
+
+bool cm256_transport_receive_decode(cm256_transport_t * transport, cm256_decoder_t * decoder, std::list<std::vector<uint8_t>> & dst_data_list)
+{
+    if (nullptr == decoder)
+    {
+        return false;
+    }
+
+    std::list<std::vector<uint8_t>> data_list;
+    if (!cm256_transport_receive(transport, data_list))
+    {
+        return false;
+    }
+
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = data_list.begin(); data_list.end() != iter; ++iter)
+    {
+        cm256_decoder_decode(decoder, iter->data(), iter->size(), dst_data_list);
+    }
+
+    return true;
+}
@@ -0,0 +1,206 @@
+/********************************************************
+ * Description : minimal io_uring ring for the transport
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#include "cm256_uring.h"
+
+#ifdef CM256_TRANSPORT_URING
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include <cstring>
+
+uring_t::uring_t()
+    : m_fd(-1)
+    , m_sq_ring(MAP_FAILED)
+    , m_sq_ring_bytes(0)
+    , m_cq_ring(MAP_FAILED)
+    , m_cq_ring_bytes(0)
+    , m_sqes(nullptr)
+    , m_sqes_bytes(0)
+    , m_sq_head(nullptr)
+    , m_sq_tail(nullptr)
+    , m_sq_array(nullptr)
+    , m_sq_mask(0)
+    , m_sq_entries(0)
+    , m_sq_local_tail(0)
+    , m_cq_head(nullptr)
+    , m_cq_tail(nullptr)
+    , m_cqes(nullptr)
+    , m_cq_mask(0)
+{
+}
+
+uring_t::~uring_t()
+{
+    destroy();
+}
+
+void uring_t::destroy()
+{
+    /* closing the ring cancels what is still in flight, so the caller's buffers may go after this */
+    if (nullptr != m_sqes)
+    {
+        munmap(m_sqes, m_sqes_bytes);
+        m_sqes = nullptr;
+    }
+    if (MAP_FAILED != m_cq_ring && m_cq_ring != m_sq_ring)
+    {
+        munmap(m_cq_ring, m_cq_ring_bytes);
+    }
+    m_cq_ring = MAP_FAILED;
+    if (MAP_FAILED != m_sq_ring)
+    {
+        munmap(m_sq_ring, m_sq_ring_bytes);
+        m_sq_ring = MAP_FAILED;
+    }
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+        m_fd = -1;
+    }
+}
+
+bool uring_t::create(unsigned entries, const struct iovec * buffers, unsigned buffer_count)
+{
+    struct io_uring_params params;
+    memset(&params, 0x0, sizeof(params));
+
+    m_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (m_fd < 0)
+    {
+        return false;
+    }
+
+    m_sq_ring_bytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cq_ring_bytes = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (0 != (params.features & IORING_FEAT_SINGLE_MMAP))
+    {
+        m_sq_ring_bytes = (m_sq_ring_bytes > m_cq_ring_bytes ? m_sq_ring_bytes : m_cq_ring_bytes);
+        m_cq_ring_bytes = m_sq_ring_bytes;
+    }
+
+    m_sq_ring = mmap(nullptr, m_sq_ring_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+    if (MAP_FAILED == m_sq_ring)
+    {
+        destroy();
+        return false;
+    }
+
+    if (0 != (params.features & IORING_FEAT_SINGLE_MMAP))
+    {
+        m_cq_ring = m_sq_ring;
+    }
+    else
+    {
+        m_cq_ring = mmap(nullptr, m_cq_ring_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+        if (MAP_FAILED == m_cq_ring)
+        {
+            destroy();
+            return false;
+        }
+    }
+
+    m_sqes_bytes = params.sq_entries * sizeof(struct io_uring_sqe);
+    void * sqes = mmap(nullptr, m_sqes_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+    if (MAP_FAILED == sqes)
+    {
+        destroy();
+        return false;
+    }
+    m_sqes = reinterpret_cast<struct io_uring_sqe *>(sqes);
+
+    uint8_t * sq_ring = reinterpret_cast<uint8_t *>(m_sq_ring);
+    m_sq_head = reinterpret_cast<unsigned *>(sq_ring + params.sq_off.head);
+    m_sq_tail = reinterpret_cast<unsigned *>(sq_ring + params.sq_off.tail);
+    m_sq_array = reinterpret_cast<unsigned *>(sq_ring + params.sq_off.array);
+    m_sq_mask = *reinterpret_cast<unsigned *>(sq_ring + params.sq_off.ring_mask);
+    m_sq_entries = params.sq_entries;
+    m_sq_local_tail = *m_sq_tail;
+
+    uint8_t * cq_ring = reinterpret_cast<uint8_t *>(m_cq_ring);
+    m_cq_head = reinterpret_cast<unsigned *>(cq_ring + params.cq_off.head);
+    m_cq_tail = reinterpret_cast<unsigned *>(cq_ring + params.cq_off.tail);
+    m_cqes = reinterpret_cast<struct io_uring_cqe *>(cq_ring + params.cq_off.cqes);
+    m_cq_mask = *reinterpret_cast<unsigned *>(cq_ring + params.cq_off.ring_mask);
+
+    if (0 != buffer_count && 0 != syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_BUFFERS, buffers, buffer_count))
+    {
+        destroy();
+        return false;
+    }
+
+    return true;
+}
+
+struct io_uring_sqe * uring_t::get_sqe()
+{
+    const unsigned head = __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+    if (m_sq_local_tail - head >= m_sq_entries)
+    {
+        return nullptr;
+    }
+
+    const unsigned index = m_sq_local_tail & m_sq_mask;
+    struct io_uring_sqe * sqe = &m_sqes[index];
+    memset(sqe, 0x0, sizeof(*sqe));
+    m_sq_array[index] = index;
+    ++m_sq_local_tail;
+    return sqe;
+}
+
+int uring_t::enter(unsigned wait_count)
+{
+    __atomic_store_n(m_sq_tail, m_sq_local_tail, __ATOMIC_RELEASE);
+
+    while (true)
+    {
+        /* entries the kernel has not consumed yet, an interrupted call leaves them in the ring */
+        const unsigned submit_count = m_sq_local_tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+        const unsigned flags = (0 != wait_count ? IORING_ENTER_GETEVENTS : 0);
+        if (0 == submit_count && (0 == wait_count || ready_count() >= wait_count))
+        {
+            return 0;
+        }
+
+        const long ret = syscall(__NR_io_uring_enter, m_fd, submit_count, wait_count, flags, nullptr, 0);
+        if (ret >= 0)
+        {
+            return 0;
+        }
+        if (EINTR != errno)
+        {
+            return -errno;
+        }
+    }
+}
+
+bool uring_t::pop_cqe(uint64_t & user_data, int & result)
+{
+    const unsigned head = *m_cq_head;
+    if (head == __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE))
+    {
+        return false;
+    }
+
+    const struct io_uring_cqe & cqe = m_cqes[head & m_cq_mask];
+    user_data = cqe.user_data;
+    result = cqe.res;
+    __atomic_store_n(m_cq_head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+unsigned uring_t::ready_count() const
+{
+    return __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE) - *m_cq_head;
+}
+
+#endif // CM256_TRANSPORT_URING
@@ -0,0 +1,448 @@
+/********************************************************
+ * Description : cm256 wide frame codec
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#ifdef _MSC_VER
+#include <winsock2.h>
+#else
+#include <arpa/inet.h>
+#endif // _MSC_VER
+
+#include <cstring>
+
+#include "cm65536.h"
+#include "cm256_wide.h"
+
+#pragma pack(push, 1)
+
+struct wide_block_header_t
+{
+    uint16_t            frame_index;
+    uint8_t             frame_filter;
+    uint8_t             reserved;
+    uint16_t            block_index;
+    uint16_t            original_count;
+    uint16_t            recovery_count;
+};
+
+struct wide_block_body_t
+{
+    uint16_t            block_bytes;
+    char                block_chunk[1];
+};
+
+struct wide_block_t
+{
+    wide_block_header_t header;
+    wide_block_body_t   body;
+};
+
+#pragma pack(pop)
+
+static const std::size_t WIDE_FRAME_BLOCK_COUNT = 1024;
+static const std::size_t WIDE_FRAME_BLOCK_LIMIT = 65535;
+
+wide_frame_header_t::wide_frame_header_t()
+    : frame_index(0)
+    , frame_filter(0)
+    , original_count(0)
+    , recovery_count(0)
+    , block_count(0)
+    , block_size(0)
+    , block_bitmap()
+{
+}
+
+static CM65536 & get_cm65536()
+{
+    static CM65536 s_cm65536;
+    return s_cm65536;
+}
+
+static void fill_block_header(wide_block_header_t & header, uint16_t frame_index, uint8_t frame_filter, uint16_t block_index, uint16_t original_count, uint16_t recovery_count)
+{
+    header.frame_index = htons(frame_index);
+    header.frame_filter = frame_filter;
+    header.reserved = 0;
+    header.block_index = htons(block_index);
+    header.original_count = htons(original_count);
+    header.recovery_count = htons(recovery_count);
+}
+
+static bool create_original_blocks(std::vector<CM65536::cm65536_block> & blocks, std::list<std::vector<uint8_t>> & original_blocks, uint16_t frame_index, uint8_t frame_filter, uint16_t original_count, uint16_t recovery_count, uint16_t block_bytes, std::list<std::vector<uint8_t>>::const_iterator & iter)
+{
+    const std::size_t block_size = sizeof(wide_block_header_t) + sizeof(uint16_t) + block_bytes;
+
+    for (uint16_t block_index = 0; block_index < original_count; ++block_index)
+    {
+        const std::vector<uint8_t> & data = *iter++;
+        if (data.size() > block_bytes)
+        {
+            return false;
+        }
+
+        std::vector<uint8_t> original_buffer(block_size, 0x0);
+
+        wide_block_t * block = reinterpret_cast<wide_block_t *>(&original_buffer[0]);
+        fill_block_header(block->header, frame_index, frame_filter, block_index, original_count, recovery_count);
+        if (!data.empty())
+        {
+            memcpy(block->body.block_chunk, &data[0], data.size());
+        }
+        block->body.block_bytes = htons(static_cast<uint16_t>(data.size()));
+
+        blocks[block_index].Block = &block->body;
+        blocks[block_index].Index = block_index;
+
+        original_blocks.emplace_back(std::move(original_buffer));
+    }
+
+    return true;
+}
+
+static bool create_recovery_blocks(std::vector<CM65536::cm65536_block> & blocks, std::list<std::vector<uint8_t>> & recovery_blocks, uint16_t frame_index, uint8_t frame_filter, uint16_t original_count, uint16_t recovery_count, uint16_t block_bytes)
+{
+    if (0 == recovery_count)
+    {
+        return true;
+    }
+
+    std::vector<uint8_t *> recovery_data(recovery_count, nullptr);
+
+    const std::size_t block_size = sizeof(wide_block_header_t) + sizeof(uint16_t) + block_bytes;
+
+    for (uint16_t block_index = 0; block_index < recovery_count; ++block_index)
+    {
+        std::vector<uint8_t> recovery_buffer(block_size, 0x0);
+
+        wide_block_t * block = reinterpret_cast<wide_block_t *>(&recovery_buffer[0]);
+        fill_block_header(block->header, frame_index, frame_filter, static_cast<uint16_t>(original_count + block_index), original_count, recovery_count);
+
+        recovery_data[block_index] = reinterpret_cast<uint8_t *>(&block->body);
+
+        recovery_blocks.emplace_back(std::move(recovery_buffer));
+    }
+
+    CM65536 & cm65536 = get_cm65536();
+    if (!cm65536.isInitialized())
+    {
+        return false;
+    }
+
+    CM65536::cm65536_encoder_params params = { original_count, recovery_count, static_cast<int>(sizeof(uint16_t) + block_bytes) };
+    if (0 != cm65536.cm65536_encode(params, &blocks[0], &recovery_data[0]))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+static uint16_t get_recovery_count(uint16_t original_count, double recovery_rate)
+{
+    std::size_t recovery_count = static_cast<std::size_t>(static_cast<double>(original_count) * recovery_rate / (1.0 - recovery_rate) + 0.5);
+    if (recovery_count > WIDE_FRAME_BLOCK_LIMIT - original_count)
+    {
+        recovery_count = WIDE_FRAME_BLOCK_LIMIT - original_count;
+    }
+    return static_cast<uint16_t>(recovery_count);
+}
+
+static uint16_t get_original_count(double recovery_rate, uint16_t block_bytes, std::size_t max_original_count, std::size_t max_frame_bytes)
+{
+    std::size_t original_count = static_cast<std::size_t>(static_cast<double>(WIDE_FRAME_BLOCK_COUNT) * (1.0 - recovery_rate) + 0.5);
+
+    if (0 != max_original_count)
+    {
+        original_count = max_original_count;
+    }
+
+    if (0 != max_frame_bytes)
+    {
+        const std::size_t block_size = sizeof(wide_block_header_t) + sizeof(uint16_t) + block_bytes;
+        const std::size_t frame_original_count = (max_frame_bytes > block_size ? max_frame_bytes / block_size : 1);
+        if (original_count > frame_original_count)
+        {
+            original_count = frame_original_count;
+        }
+    }
+
+    if (original_count > WIDE_FRAME_BLOCK_LIMIT)
+    {
+        original_count = WIDE_FRAME_BLOCK_LIMIT;
+    }
+
+    if (0 == original_count)
+    {
+        original_count = 1;
+    }
+
+    return static_cast<uint16_t>(original_count);
+}
+
+bool cm256_wide_encode(uint16_t & frame_index, uint8_t & frame_filter, std::list<std::vector<uint8_t>> & dst_data_list, const std::list<std::vector<uint8_t>> & src_data_list, double recovery_rate, std::size_t max_data_size, bool recovery_force, std::size_t max_original_count, std::size_t max_frame_bytes)
+{
+    if (recovery_rate < 0.0 || recovery_rate >= 1.0)
+    {
+        return false;
+    }
+
+    if (0 == max_data_size)
+    {
+        for (std::list<std::vector<uint8_t>>::const_iterator iter = src_data_list.begin(); src_data_list.end() != iter; ++iter)
+        {
+            if (max_data_size < iter->size())
+            {
+                max_data_size = iter->size();
+            }
+        }
+    }
+    /* the block, header and length prefix included, must fit the 16-bit size the decoder takes */
+    if (max_data_size >= 65535 || sizeof(wide_block_header_t) + sizeof(uint16_t) + ((max_data_size + 1) & ~static_cast<std::size_t>(1)) > 65535)
+    {
+        return false;
+    }
+
+    std::size_t data_list_left = src_data_list.size();
+    std::list<std::vector<uint8_t>>::const_iterator iter = src_data_list.begin();
+
+    /* GF(2^16) symbols are two bytes wide, so the block body (length prefix included) is padded to even */
+    uint16_t block_bytes = static_cast<uint16_t>((max_data_size + 1) & ~static_cast<std::size_t>(1));
+    uint16_t original_count = get_original_count(recovery_rate, block_bytes, max_original_count, max_frame_bytes);
+    uint16_t recovery_count = get_recovery_count(original_count, recovery_rate);
+
+    while (0 != data_list_left)
+    {
+        if (original_count > data_list_left)
+        {
+            original_count = static_cast<uint16_t>(data_list_left);
+            recovery_count = get_recovery_count(original_count, recovery_rate);
+        }
+        if (recovery_force && recovery_rate > 0.0 && 0 == recovery_count)
+        {
+            recovery_count = 1;
+        }
+        data_list_left -= original_count;
+
+        std::vector<CM65536::cm65536_block> blocks(original_count);
+
+        std::list<std::vector<uint8_t>> original_blocks;
+        if (!create_original_blocks(blocks, original_blocks, frame_index, frame_filter, original_count, recovery_count, block_bytes, iter))
+        {
+            return false;
+        }
+
+        std::list<std::vector<uint8_t>> recovery_blocks;
+        if (!create_recovery_blocks(blocks, recovery_blocks, frame_index, frame_filter, original_count, recovery_count, block_bytes))
+        {
+            return false;
+        }
+
+        dst_data_list.splice(dst_data_list.end(), original_blocks);
+        dst_data_list.splice(dst_data_list.end(), recovery_blocks);
+
+        if (0 == ++frame_index)
+        {
+            ++frame_filter;
+        }
+    }
+
+    return true;
+}
+
+static bool is_same_frame(const wide_block_header_t & block_header, uint16_t block_size, const wide_frame_header_t & frame_header)
+{
+    return block_size == frame_header.block_size && 
+        ntohs(block_header.frame_index) == frame_header.frame_index && block_header.frame_filter == frame_header.frame_filter && 
+        ntohs(block_header.original_count) == frame_header.original_count && ntohs(block_header.recovery_count) == frame_header.recovery_count;
+}
+
+static bool insert_frame_block(const void * data, std::size_t data_len, wide_frames_t & frames, uint16_t & frame_index, uint32_t max_delay_microseconds)
+{
+    if (data_len < sizeof(wide_block_header_t) + sizeof(uint16_t) || data_len > 65535 || 0 != ((data_len - sizeof(wide_block_header_t)) & 1))
+    {
+        return false;
+    }
+
+    const wide_block_t * block = reinterpret_cast<const wide_block_t *>(data);
+    const uint16_t block_size = static_cast<uint16_t>(data_len);
+
+    const wide_block_header_t & block_header = block->header;
+    const uint16_t block_index = ntohs(block_header.block_index);
+    const uint16_t original_count = ntohs(block_header.original_count);
+    const uint16_t recovery_count = ntohs(block_header.recovery_count);
+
+    if (0 == original_count || static_cast<std::size_t>(original_count) + recovery_count > WIDE_FRAME_BLOCK_LIMIT || block_index >= original_count + recovery_count)
+    {
+        return false;
+    }
+
+    frame_index = ntohs(block_header.frame_index);
+
+    wide_frame_t & frame = frames.item[frame_index];
+    wide_frame_header_t & frame_header = frame.header;
+    frame_body_t & frame_body = frame.body;
+
+    if (0 == frame_header.block_count)
+    {
+        /* a frame already decoded keeps its header so that its late blocks are dropped */
+        if (0 != frame_header.original_count && is_same_frame(block_header, block_size, frame_header))
+        {
+            return false;
+        }
+
+        frame_header.block_size = block_size;
+        frame_header.frame_index = frame_index;
+        frame_header.frame_filter = block_header.frame_filter;
+        frame_header.original_count = original_count;
+        frame_header.recovery_count = recovery_count;
+        /* sized by the frame's own blocks, a frame index seen once must not hold a bitmap for 65535 of them */
+        frame_header.block_bitmap.assign((static_cast<std::size_t>(original_count) + recovery_count + 7) / 8, 0x0);
+
+        decode_timer_t decode_timer = { 0x0 };
+        decode_timer.frame_index = frame_index;
+        cm256_get_time(decode_timer.start_seconds, decode_timer.start_microseconds);
+        decode_timer.decode_seconds = decode_timer.start_seconds + static_cast<uint32_t>(static_cast<uint64_t>(max_delay_microseconds) * original_count / 1000000);
+        decode_timer.decode_microseconds = decode_timer.start_microseconds + static_cast<uint32_t>(static_cast<uint64_t>(max_delay_microseconds) * original_count % 1000000);
+        decode_timer.decode_seconds += decode_timer.decode_microseconds / 1000000;
+        decode_timer.decode_microseconds %= 1000000;
+
+        frames.decode_timer_list.push_back(decode_timer);
+    }
+    else if (!is_same_frame(block_header, block_size, frame_header) || frame_header.block_count == frame_header.original_count)
+    {
+        return false;
+    }
+
+    if (frame_header.block_bitmap[block_index >> 3] & (1 << (block_index & 7)))
+    {
+        return false;
+    }
+
+    frame_header.block_bitmap[block_index >> 3] |= (1 << (block_index & 7));
+    if (block_index < original_count)
+    {
+        frame_body.original_list.emplace_back(std::vector<uint8_t>(reinterpret_cast<const uint8_t *>(block), reinterpret_cast<const uint8_t *>(block) + block_size));
+    }
+    else
+    {
+        frame_body.recovery_list.emplace_back(std::vector<uint8_t>(reinterpret_cast<const uint8_t *>(block), reinterpret_cast<const uint8_t *>(block) + block_size));
+    }
+    frame_header.block_count += 1;
+
+    return true;
+}
+
+static bool cm256_wide_decode(wide_frame_header_t & frame_header, frame_body_t & frame_body, std::list<std::vector<uint8_t>> & src_data_list)
+{
+    frame_header.block_count = 0;
+
+    src_data_list.clear();
+    src_data_list.swap(frame_body.original_list);
+
+    if (!frame_body.recovery_list.empty())
+    {
+        if (src_data_list.size() + frame_body.recovery_list.size() == frame_header.original_count)
+        {
+            src_data_list.splice(src_data_list.end(), frame_body.recovery_list);
+
+            std::vector<CM65536::cm65536_block> blocks(frame_header.original_count);
+
+            std::size_t block_index = 0;
+            for (std::list<std::vector<uint8_t>>::iterator iter = src_data_list.begin(); src_data_list.end() != iter; ++iter)
+            {
+                std::vector<uint8_t> & data = *iter;
+                wide_block_t * block = reinterpret_cast<wide_block_t *>(&data[0]);
+                blocks[block_index].Block = &block->body;
+                blocks[block_index].Index = ntohs(block->header.block_index);
+                ++block_index;
+            }
+
+            CM65536 & cm65536 = get_cm65536();
+            if (!cm65536.isInitialized())
+            {
+                return false;
+            }
+
+            CM65536::cm65536_encoder_params params = { frame_header.original_count, frame_header.recovery_count, static_cast<int>(frame_header.block_size - sizeof(wide_block_header_t)) };
+            if (0 != cm65536.cm65536_decode(params, &blocks[0]))
+            {
+                src_data_list.clear();
+                return false;
+            }
+        }
+        else
+        {
+            frame_body.recovery_list.clear();
+        }
+    }
+
+    for (std::list<std::vector<uint8_t>>::iterator iter = src_data_list.begin(); src_data_list.end() != iter; ++iter)
+    {
+        std::vector<uint8_t> & data = *iter;
+        wide_block_t * block = reinterpret_cast<wide_block_t *>(&data[0]);
+        const std::size_t block_bytes = ntohs(block->body.block_bytes);
+        if (block_bytes + sizeof(wide_block_header_t) + sizeof(uint16_t) > data.size())
+        {
+            data.clear();
+            continue;
+        }
+        std::vector<uint8_t>(block->body.block_chunk, block->body.block_chunk + block_bytes).swap(data);
+    }
+
+    return true;
+}
+
+bool cm256_wide_decode(const void * data, std::size_t data_len, wide_frames_t & frames, std::list<std::vector<uint8_t>> & dst_data_list, uint32_t max_delay_microseconds, bool recovery_force)
+{
+    bool need_decode = recovery_force;
+
+    if (nullptr != data && 0 != data_len)
+    {
+        uint16_t frame_index = 0;
+        if (insert_frame_block(data, data_len, frames, frame_index, max_delay_microseconds))
+        {
+            const wide_frame_t & frame = frames.item[frame_index];
+            if (frame.header.block_count == frame.header.original_count)
+            {
+                need_decode = true;
+            }
+        }
+    }
+    else
+    {
+        need_decode = true;
+    }
+
+    if (need_decode)
+    {
+        uint32_t current_seconds = 0;
+        uint32_t current_microseconds = 0;
+        cm256_get_time(current_seconds, current_microseconds);
+        std::list<decode_timer_t>::iterator iter = frames.decode_timer_list.begin();
+        while (frames.decode_timer_list.end() != iter)
+        {
+            const decode_timer_t & decode_timer = *iter;
+            wide_frame_t & frame = frames.item[decode_timer.frame_index];
+            if ((decode_timer.decode_seconds < current_seconds) || (decode_timer.decode_seconds == current_seconds && decode_timer.decode_microseconds < current_microseconds) || 
+                (frame.header.block_count == frame.header.original_count))
+            {
+                std::list<std::vector<uint8_t>> src_data_list;
+                cm256_wide_decode(frame.header, frame.body, src_data_list);
+                dst_data_list.splice(dst_data_list.end(), src_data_list);
+                iter = frames.decode_timer_list.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+    }
+
+    return true;
+}
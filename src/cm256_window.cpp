@@ -0,0 +1,416 @@
+/********************************************************
+ * Description : cm256 sliding window codec
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#ifdef _MSC_VER
+#include <winsock2.h>
+#else
+#include <arpa/inet.h>
+#endif // _MSC_VER
+
+#include <cstring>
+
+#include "gf256.h"
+#include "cm256_window.h"
+
+#pragma pack(push, 1)
+
+struct window_header_t
+{
+    uint16_t            sequence;
+    uint8_t             repair_flag;
+    uint8_t             window_count;
+    uint16_t            window_begin;
+};
+
+#pragma pack(pop)
+
+window_encoder_t::window_encoder_t()
+    : sequence(0)
+    , repair_sequence(0)
+    , repair_credit(0.0)
+    , source_list()
+{
+}
+
+window_decoder_t::window_decoder_t()
+    : started(false)
+    , sequence(0)
+    , source_map()
+    , row_map()
+{
+}
+
+static gf256_ctx & get_gf256()
+{
+    static gf256_ctx s_gf256;
+    return s_gf256;
+}
+
+static uint8_t get_coefficient(uint16_t repair_sequence, uint16_t sequence)
+{
+    uint32_t value = (static_cast<uint32_t>(repair_sequence) << 16) | sequence;
+    value ^= value >> 16;
+    value *= 0x7feb352d;
+    value ^= value >> 15;
+    value *= 0x846ca68b;
+    value ^= value >> 16;
+    return static_cast<uint8_t>(1 + value % 255);
+}
+
+static void muladd_symbol(std::vector<uint8_t> & dst_symbol, uint8_t coefficient, const std::vector<uint8_t> & src_symbol)
+{
+    if (dst_symbol.size() < src_symbol.size())
+    {
+        dst_symbol.resize(src_symbol.size(), 0x0);
+    }
+    if (!src_symbol.empty())
+    {
+        get_gf256().gf256_muladd_mem(&dst_symbol[0], coefficient, &src_symbol[0], static_cast<int>(src_symbol.size()));
+    }
+}
+
+static bool create_repair_block(window_encoder_t & encoder, std::list<std::vector<uint8_t>> & dst_data_list)
+{
+    if (encoder.source_list.empty())
+    {
+        return true;
+    }
+
+    std::size_t symbol_size = 0;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = encoder.source_list.begin(); encoder.source_list.end() != iter; ++iter)
+    {
+        if (symbol_size < iter->size())
+        {
+            symbol_size = iter->size();
+        }
+    }
+
+    std::vector<uint8_t> repair_buffer(sizeof(window_header_t) + symbol_size, 0x0);
+
+    const uint16_t window_begin = static_cast<uint16_t>(encoder.sequence - encoder.source_list.size());
+
+    window_header_t * header = reinterpret_cast<window_header_t *>(&repair_buffer[0]);
+    header->sequence = htons(encoder.repair_sequence);
+    header->repair_flag = 1;
+    header->window_count = static_cast<uint8_t>(encoder.source_list.size());
+    header->window_begin = htons(window_begin);
+
+    uint8_t * repair_symbol = &repair_buffer[sizeof(window_header_t)];
+
+    uint16_t sequence = window_begin;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = encoder.source_list.begin(); encoder.source_list.end() != iter; ++iter, ++sequence)
+    {
+        get_gf256().gf256_muladd_mem(repair_symbol, get_coefficient(encoder.repair_sequence, sequence), &(*iter)[0], static_cast<int>(iter->size()));
+    }
+
+    ++encoder.repair_sequence;
+
+    dst_data_list.emplace_back(std::move(repair_buffer));
+
+    return true;
+}
+
+bool cm256_window_encode(const void * data, std::size_t data_len, window_encoder_t & encoder, std::list<std::vector<uint8_t>> & dst_data_list, double recovery_rate, std::size_t window_size)
+{
+    if (recovery_rate < 0.0 || recovery_rate >= 1.0)
+    {
+        return false;
+    }
+
+    if (0 == window_size || window_size > 255)
+    {
+        return false;
+    }
+
+    if (nullptr == data || data_len >= 65536)
+    {
+        return false;
+    }
+
+    if (!get_gf256().isInitialized())
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> source_buffer(sizeof(window_header_t) + sizeof(uint16_t) + data_len, 0x0);
+
+    window_header_t * header = reinterpret_cast<window_header_t *>(&source_buffer[0]);
+    header->sequence = htons(encoder.sequence);
+    header->repair_flag = 0;
+    header->window_count = 0;
+    header->window_begin = htons(encoder.sequence);
+
+    const uint16_t block_bytes = htons(static_cast<uint16_t>(data_len));
+    memcpy(&source_buffer[sizeof(window_header_t)], &block_bytes, sizeof(uint16_t));
+    if (0 != data_len)
+    {
+        memcpy(&source_buffer[sizeof(window_header_t) + sizeof(uint16_t)], data, data_len);
+    }
+
+    encoder.source_list.emplace_back(source_buffer.begin() + sizeof(window_header_t), source_buffer.end());
+    while (encoder.source_list.size() > window_size)
+    {
+        encoder.source_list.pop_front();
+    }
+
+    dst_data_list.emplace_back(std::move(source_buffer));
+
+    ++encoder.sequence;
+
+    encoder.repair_credit += recovery_rate / (1.0 - recovery_rate);
+    while (encoder.repair_credit >= 1.0)
+    {
+        if (!create_repair_block(encoder, dst_data_list))
+        {
+            return false;
+        }
+        encoder.repair_credit -= 1.0;
+    }
+
+    return true;
+}
+
+static uint32_t get_sequence(const window_decoder_t & decoder, uint16_t sequence)
+{
+    return decoder.sequence + static_cast<int16_t>(sequence - static_cast<uint16_t>(decoder.sequence));
+}
+
+static void trim_row(window_row_t & row)
+{
+    std::size_t head = 0;
+    while (head < row.coefficient.size() && 0 == row.coefficient[head])
+    {
+        ++head;
+    }
+
+    std::size_t tail = row.coefficient.size();
+    while (tail > head && 0 == row.coefficient[tail - 1])
+    {
+        --tail;
+    }
+
+    if (0 != head || row.coefficient.size() != tail)
+    {
+        row.begin += static_cast<uint32_t>(head);
+        std::vector<uint8_t>(row.coefficient.begin() + head, row.coefficient.begin() + tail).swap(row.coefficient);
+    }
+}
+
+static void insert_row(window_decoder_t & decoder, window_row_t & row)
+{
+    gf256_ctx & gf256 = get_gf256();
+
+    while (true)
+    {
+        trim_row(row);
+        if (row.coefficient.empty())
+        {
+            return;
+        }
+
+        std::map<uint32_t, window_row_t>::iterator iter = decoder.row_map.find(row.begin);
+        if (decoder.row_map.end() == iter)
+        {
+            const uint8_t pivot = row.coefficient[0];
+            if (1 != pivot)
+            {
+                gf256.gf256_div_mem(&row.coefficient[0], &row.coefficient[0], pivot, static_cast<int>(row.coefficient.size()));
+                gf256.gf256_div_mem(&row.symbol[0], &row.symbol[0], pivot, static_cast<int>(row.symbol.size()));
+            }
+            window_row_t & pivot_row = decoder.row_map[row.begin];
+            pivot_row.begin = row.begin;
+            pivot_row.coefficient.swap(row.coefficient);
+            pivot_row.symbol.swap(row.symbol);
+            return;
+        }
+
+        /* eliminate the pivot with the row that already owns it, whose pivot coefficient is 1 */
+        const window_row_t & pivot_row = iter->second;
+        if (row.coefficient.size() < pivot_row.coefficient.size())
+        {
+            row.coefficient.resize(pivot_row.coefficient.size(), 0x0);
+        }
+        const uint8_t factor = row.coefficient[0];
+        gf256.gf256_muladd_mem(&row.coefficient[0], factor, &pivot_row.coefficient[0], static_cast<int>(pivot_row.coefficient.size()));
+        muladd_symbol(row.symbol, factor, pivot_row.symbol);
+    }
+}
+
+static void eliminate_source(window_decoder_t & decoder, uint32_t sequence, const std::vector<uint8_t> & symbol)
+{
+    std::list<window_row_t> row_list;
+
+    std::map<uint32_t, window_row_t>::iterator iter = decoder.row_map.begin();
+    while (decoder.row_map.end() != iter && iter->first <= sequence)
+    {
+        window_row_t & row = iter->second;
+        if (sequence < row.begin + row.coefficient.size() && 0 != row.coefficient[sequence - row.begin])
+        {
+            muladd_symbol(row.symbol, row.coefficient[sequence - row.begin], symbol);
+            row.coefficient[sequence - row.begin] = 0;
+            if (row.begin == sequence)
+            {
+                row_list.emplace_back();
+                row_list.back().begin = row.begin;
+                row_list.back().coefficient.swap(row.coefficient);
+                row_list.back().symbol.swap(row.symbol);
+                decoder.row_map.erase(iter++);
+                continue;
+            }
+            trim_row(row);
+        }
+        ++iter;
+    }
+
+    for (std::list<window_row_t>::iterator row_iter = row_list.begin(); row_list.end() != row_iter; ++row_iter)
+    {
+        insert_row(decoder, *row_iter);
+    }
+}
+
+static void insert_source(window_decoder_t & decoder, uint32_t sequence, std::vector<uint8_t> & symbol, std::list<std::vector<uint8_t>> & dst_data_list)
+{
+    uint16_t block_bytes = 0;
+    memcpy(&block_bytes, &symbol[0], sizeof(uint16_t));
+    block_bytes = ntohs(block_bytes);
+    if (sizeof(uint16_t) + block_bytes > symbol.size())
+    {
+        return;
+    }
+    symbol.resize(sizeof(uint16_t) + block_bytes);
+
+    dst_data_list.emplace_back(symbol.begin() + sizeof(uint16_t), symbol.end());
+
+    std::vector<uint8_t> & source = decoder.source_map[sequence];
+    source.swap(symbol);
+
+    eliminate_source(decoder, sequence, source);
+}
+
+static void solve_rows(window_decoder_t & decoder, std::list<std::vector<uint8_t>> & dst_data_list)
+{
+    bool solved = true;
+    while (solved)
+    {
+        solved = false;
+        for (std::map<uint32_t, window_row_t>::iterator iter = decoder.row_map.begin(); decoder.row_map.end() != iter; ++iter)
+        {
+            if (1 == iter->second.coefficient.size())
+            {
+                const uint32_t sequence = iter->first;
+                std::vector<uint8_t> symbol;
+                symbol.swap(iter->second.symbol);
+                decoder.row_map.erase(iter);
+                insert_source(decoder, sequence, symbol, dst_data_list);
+                solved = true;
+                break;
+            }
+        }
+    }
+}
+
+/* sources and rows before this sequence are forgotten, so no packet may reach back there */
+static uint32_t get_expire_before(const window_decoder_t & decoder, std::size_t window_size)
+{
+    return (decoder.sequence < window_size * 2 ? 0 : static_cast<uint32_t>(decoder.sequence - window_size * 2));
+}
+
+static void expire_window(window_decoder_t & decoder, std::size_t window_size)
+{
+    const uint32_t sequence = get_expire_before(decoder, window_size);
+
+    while (!decoder.source_map.empty() && decoder.source_map.begin()->first < sequence)
+    {
+        decoder.source_map.erase(decoder.source_map.begin());
+    }
+
+    while (!decoder.row_map.empty() && decoder.row_map.begin()->first < sequence)
+    {
+        decoder.row_map.erase(decoder.row_map.begin());
+    }
+}
+
+bool cm256_window_decode(const void * data, std::size_t data_len, window_decoder_t & decoder, std::list<std::vector<uint8_t>> & dst_data_list, std::size_t window_size)
+{
+    if (nullptr == data || data_len < sizeof(window_header_t) + sizeof(uint16_t))
+    {
+        return false;
+    }
+
+    if (!get_gf256().isInitialized())
+    {
+        return false;
+    }
+
+    const window_header_t * header = reinterpret_cast<const window_header_t *>(data);
+    const uint8_t * symbol_data = reinterpret_cast<const uint8_t *>(data) + sizeof(window_header_t);
+    const std::size_t symbol_size = data_len - sizeof(window_header_t);
+
+    if (!decoder.started)
+    {
+        decoder.started = true;
+        decoder.sequence = 0x10000 + ntohs(header->window_begin);
+    }
+
+    const uint32_t window_begin = get_sequence(decoder, ntohs(header->window_begin));
+    const uint32_t window_end = window_begin + (0 == header->repair_flag ? 1 : header->window_count);
+
+    /*
+     * a source there may have been delivered and forgotten, and a repair covering one could only
+     * take it for unknown and deliver it again, the expired symbols being gone
+     */
+    if (window_begin < get_expire_before(decoder, window_size))
+    {
+        return true;
+    }
+
+    if (decoder.sequence < window_end)
+    {
+        decoder.sequence = window_end;
+    }
+
+    if (0 == header->repair_flag)
+    {
+        if (decoder.source_map.end() == decoder.source_map.find(window_begin))
+        {
+            std::vector<uint8_t> symbol(symbol_data, symbol_data + symbol_size);
+            insert_source(decoder, window_begin, symbol, dst_data_list);
+            solve_rows(decoder, dst_data_list);
+        }
+    }
+    else if (0 != header->window_count)
+    {
+        const uint16_t repair_sequence = ntohs(header->sequence);
+
+        window_row_t row;
+        row.begin = window_begin;
+        row.coefficient.resize(header->window_count, 0x0);
+        row.symbol.assign(symbol_data, symbol_data + symbol_size);
+
+        for (uint8_t index = 0; index < header->window_count; ++index)
+        {
+            std::map<uint32_t, std::vector<uint8_t>>::const_iterator iter = decoder.source_map.find(window_begin + index);
+            if (decoder.source_map.end() != iter)
+            {
+                muladd_symbol(row.symbol, get_coefficient(repair_sequence, static_cast<uint16_t>(window_begin + index)), iter->second);
+            }
+            else
+            {
+                row.coefficient[index] = get_coefficient(repair_sequence, static_cast<uint16_t>(window_begin + index));
+            }
+        }
+
+        insert_row(decoder, row);
+        solve_rows(decoder, dst_data_list);
+    }
+
+    expire_window(decoder, window_size);
+
+    return true;
+}
@@ -0,0 +1,199 @@
+/********************************************************
+ * Description : cm256 wire format
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#include "cm256_wire.h"
+#include "cm256_crc32c.h"
+
+/* version 1: frame_index (big endian), frame_filter, block_index, original_count, recovery_count, then the body */
+static const std::size_t WIRE_V1_HEADER_BYTES = 6;
+static const std::size_t WIRE_V1_LENGTH_BYTES = 2;
+static const std::size_t WIRE_V2_HEADER_BYTES = 5;
+static const std::size_t WIRE_V2_COUNTS_BYTES = 2;
+
+static const uint8_t WIRE_FLAG_COUNTS = 0x1;
+static const uint8_t WIRE_FLAG_BODY = 0x2;
+static const uint8_t WIRE_FLAG_MASK = WIRE_FLAG_COUNTS | WIRE_FLAG_BODY;
+static const std::size_t WIRE_CHECKSUM_BYTES = 4;
+
+wire_format_t::wire_format_t()
+    : version(1)
+    , block_bytes(0)
+    , original_count(0)
+    , recovery_count(0)
+    , checksum(false)
+{
+}
+
+static void append_checksum(std::vector<uint8_t> & block)
+{
+    const uint32_t crc = cm256_crc32c(block.data(), block.size());
+    const uint8_t trailer[WIRE_CHECKSUM_BYTES] = { static_cast<uint8_t>(crc >> 24), static_cast<uint8_t>(crc >> 16), static_cast<uint8_t>(crc >> 8), static_cast<uint8_t>(crc) };
+    block.insert(block.end(), trailer, trailer + WIRE_CHECKSUM_BYTES);
+}
+
+bool cm256_wire_verify(const void * data, std::size_t data_len)
+{
+    if (nullptr == data || data_len <= WIRE_CHECKSUM_BYTES)
+    {
+        return false;
+    }
+
+    data_len -= WIRE_CHECKSUM_BYTES;
+    const uint8_t * trailer = reinterpret_cast<const uint8_t *>(data) + data_len;
+    const uint32_t crc = (static_cast<uint32_t>(trailer[0]) << 24) | (static_cast<uint32_t>(trailer[1]) << 16) | (static_cast<uint32_t>(trailer[2]) << 8) | trailer[3];
+    return cm256_crc32c(data, data_len) == crc;
+}
+
+static bool pack_block(const wire_format_t & format, std::vector<uint8_t> & block)
+{
+    if (block.size() < WIRE_V1_HEADER_BYTES + WIRE_V1_LENGTH_BYTES)
+    {
+        return false;
+    }
+
+    const uint8_t * src = &block[0];
+    const uint8_t block_index = src[3];
+    const uint8_t original_count = src[4];
+    const uint8_t recovery_count = src[5];
+    const std::size_t block_bytes = block.size() - WIRE_V1_HEADER_BYTES - WIRE_V1_LENGTH_BYTES;
+    const std::size_t payload_bytes = (static_cast<std::size_t>(src[6]) << 8) | src[7];
+
+    /* recovery blocks and originals of an odd sized frame keep their body, the receiver cannot rebuild it */
+    const bool counts = (0 == format.original_count || original_count != format.original_count || recovery_count != format.recovery_count);
+    const bool body = (block_index >= original_count || block_bytes != format.block_bytes || payload_bytes > block_bytes);
+    const std::size_t header_bytes = WIRE_V2_HEADER_BYTES + (counts ? WIRE_V2_COUNTS_BYTES : 0);
+
+    std::vector<uint8_t> packed(header_bytes);
+    packed[0] = static_cast<uint8_t>((2 << 4) | (counts ? WIRE_FLAG_COUNTS : 0) | (body ? WIRE_FLAG_BODY : 0));
+    packed[1] = src[2];
+    packed[2] = src[0];
+    packed[3] = src[1];
+    packed[4] = block_index;
+    if (counts)
+    {
+        packed[5] = original_count;
+        packed[6] = recovery_count;
+    }
+
+    if (body)
+    {
+        packed.insert(packed.end(), src + WIRE_V1_HEADER_BYTES, src + block.size());
+    }
+    else
+    {
+        packed.insert(packed.end(), src + WIRE_V1_HEADER_BYTES + WIRE_V1_LENGTH_BYTES, src + WIRE_V1_HEADER_BYTES + WIRE_V1_LENGTH_BYTES + payload_bytes);
+    }
+
+    packed.swap(block);
+    return true;
+}
+
+bool cm256_wire_pack(const wire_format_t & format, std::list<std::vector<uint8_t>> & data_list)
+{
+    if (1 != format.version && 2 != format.version)
+    {
+        return false;
+    }
+
+    for (std::list<std::vector<uint8_t>>::iterator iter = data_list.begin(); data_list.end() != iter; ++iter)
+    {
+        if (2 == format.version && !pack_block(format, *iter))
+        {
+            return false;
+        }
+        if (format.checksum)
+        {
+            append_checksum(*iter);
+        }
+    }
+
+    return true;
+}
+
+bool cm256_wire_unpack(const wire_format_t & format, const void * data, std::size_t data_len, std::vector<uint8_t> & block)
+{
+    const uint8_t * src = reinterpret_cast<const uint8_t *>(data);
+    if (nullptr == src || 0 == data_len)
+    {
+        return false;
+    }
+
+    if (format.checksum)
+    {
+        if (!cm256_wire_verify(src, data_len))
+        {
+            return false;
+        }
+        data_len -= WIRE_CHECKSUM_BYTES;
+    }
+
+    if (1 == format.version)
+    {
+        block.assign(src, src + data_len);
+        return true;
+    }
+
+    if (2 != format.version || data_len < WIRE_V2_HEADER_BYTES || 2 != (src[0] >> 4) || 0 != (src[0] & ~WIRE_FLAG_MASK & 0x0F))
+    {
+        return false;
+    }
+
+    /* the optional fields are sized from the flags, not branched on */
+    const uint8_t flags = src[0] & 0x0F;
+    const std::size_t counts_bytes = static_cast<std::size_t>(flags & WIRE_FLAG_COUNTS) * WIRE_V2_COUNTS_BYTES;
+    const std::size_t header_bytes = WIRE_V2_HEADER_BYTES + counts_bytes;
+    if (data_len < header_bytes)
+    {
+        return false;
+    }
+
+    const uint8_t * counts = (0 != counts_bytes ? src + WIRE_V2_HEADER_BYTES : &format.original_count);
+    const uint8_t block_index = src[4];
+    const uint8_t original_count = counts[0];
+    const uint8_t recovery_count = (0 != counts_bytes ? counts[1] : format.recovery_count);
+    if (0 == original_count || static_cast<unsigned>(block_index) >= static_cast<unsigned>(original_count) + recovery_count)
+    {
+        return false;
+    }
+
+    const std::size_t body_bytes = data_len - header_bytes;
+    if (0 != (flags & WIRE_FLAG_BODY))
+    {
+        if (body_bytes < WIRE_V1_LENGTH_BYTES)
+        {
+            return false;
+        }
+        block.resize(WIRE_V1_HEADER_BYTES + body_bytes);
+        memcpy(&block[WIRE_V1_HEADER_BYTES], src + header_bytes, body_bytes);
+    }
+    else
+    {
+        /* a bare payload is an original of a full sized frame, padded back to the agreed block bytes */
+        if (block_index >= original_count || body_bytes > format.block_bytes)
+        {
+            return false;
+        }
+        block.assign(WIRE_V1_HEADER_BYTES + WIRE_V1_LENGTH_BYTES + format.block_bytes, 0x0);
+        block[6] = static_cast<uint8_t>(body_bytes >> 8);
+        block[7] = static_cast<uint8_t>(body_bytes);
+        if (0 != body_bytes)
+        {
+            memcpy(&block[WIRE_V1_HEADER_BYTES + WIRE_V1_LENGTH_BYTES], src + header_bytes, body_bytes);
+        }
+    }
+
+    block[0] = src[2];
+    block[1] = src[3];
+    block[2] = src[1];
+    block[3] = block_index;
+    block[4] = original_count;
+    block[5] = recovery_count;
+
+    return true;
+}
@@ -0,0 +1,257 @@
+/********************************************************
+ * Description : Cauchy MDS GF(2^16) wide codec
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#include <vector>
+
+#include "cm65536.h"
+
+CM65536::CM65536()
+{
+    m_initialized = m_gf65536Ctx.isInitialized();
+}
+
+CM65536::~CM65536()
+{
+}
+
+/*
+    Matrix Form
+
+    The matrix is the GF(2^16) counterpart of the one used by CM256:
+
+        a_ij = (y_j + x_0) / (x_i + y_j)
+
+    with y_j = j for the originals, x_i = originalCount + i for the recovery
+    rows and x_0 = originalCount, so the first recovery row is all ones.
+
+    This is a Cauchy matrix c_ij = 1 / (x_i + y_j) with column j scaled by
+    d_j = (y_j + x_0).  Once the received originals are eliminated, the
+    decoder is left with the square Cauchy system picked out by the received
+    recovery rows and the erased columns, whose inverse is known in closed
+    form (all sums are differences in GF(2^16)):
+
+        b_ij = P_j Q_i / ((x_j + y_i) R_j S_i)
+
+        P_j = prod_k (x_j + y_k)      Q_i = prod_k (x_k + y_i)
+        R_j = prod_k!=j (x_j + x_k)   S_i = prod_k!=i (y_i + y_k)
+
+    Building it takes O(n^2) field operations for n erasures instead of the
+    O(n^3) of a generic elimination, which matters once frames hold
+    thousands of blocks.
+*/
+
+uint16_t CM65536::getMatrixElement(uint16_t x_i, uint16_t x_0, uint16_t y_j)
+{
+    return m_gf65536Ctx.gf65536_div(gf65536_ctx::gf65536_add(y_j, x_0), gf65536_ctx::gf65536_add(x_i, y_j));
+}
+
+//-----------------------------------------------------------------------------
+// Encoding
+
+int CM65536::cm65536_encode(
+    cm65536_encoder_params params, // Encoder parameters
+    cm65536_block* originals,      // Array of pointers to original blocks
+    uint8_t ** recoveryBlocks)     // Output recovery blocks array
+{
+    // Validate input:
+    if (params.OriginalCount <= 0 ||
+        params.RecoveryCount <= 0 ||
+        params.BlockBytes <= 0 ||
+        (params.BlockBytes & 1) != 0)
+    {
+        return -1;
+    }
+    if (params.OriginalCount + params.RecoveryCount > 65536)
+    {
+        return -2;
+    }
+    if (!originals || !recoveryBlocks)
+    {
+        return -3;
+    }
+
+    // If only one block of input data, degenerate to outputting the same data each time.
+    if (params.OriginalCount == 1)
+    {
+        for (int block = 0; block < params.RecoveryCount; ++block)
+        {
+            memcpy(recoveryBlocks[block], originals[0].Block, params.BlockBytes);
+        }
+        return 0;
+    }
+
+    // Start the x_0 values arbitrarily from the original count.
+    const uint16_t x_0 = static_cast<uint16_t>(params.OriginalCount);
+
+    for (int block = 0; block < params.RecoveryCount; ++block)
+    {
+        void* recoveryBlock = recoveryBlocks[block];
+
+        // The first row of the matrix is all ones, so it is merely a parity of the original data.
+        if (block == 0)
+        {
+            memcpy(recoveryBlock, originals[0].Block, params.BlockBytes);
+            for (int j = 1; j < params.OriginalCount; ++j)
+            {
+                gf256_ctx::gf256_add_mem(recoveryBlock, originals[j].Block, params.BlockBytes);
+            }
+            continue;
+        }
+
+        const uint16_t x_i = static_cast<uint16_t>(params.OriginalCount + block);
+
+        m_gf65536Ctx.gf65536_mul_mem(recoveryBlock, originals[0].Block, getMatrixElement(x_i, x_0, 0), params.BlockBytes);
+
+        for (int j = 1; j < params.OriginalCount; ++j)
+        {
+            m_gf65536Ctx.gf65536_muladd_mem(recoveryBlock, getMatrixElement(x_i, x_0, static_cast<uint16_t>(j)), originals[j].Block, params.BlockBytes);
+        }
+    }
+
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+// Decoding
+
+int CM65536::cm65536_decode(
+    cm65536_encoder_params params, // Encoder parameters
+    cm65536_block* blocks)         // Array of 'originalCount' blocks as described above
+{
+    if (params.OriginalCount <= 0 ||
+        params.RecoveryCount <= 0 ||
+        params.BlockBytes <= 0 ||
+        (params.BlockBytes & 1) != 0)
+    {
+        return -1;
+    }
+    if (params.OriginalCount + params.RecoveryCount > 65536)
+    {
+        return -2;
+    }
+    if (!blocks)
+    {
+        return -3;
+    }
+
+    // If there is only one block, it is the same block repeated
+    if (params.OriginalCount == 1)
+    {
+        blocks[0].Index = 0;
+        return 0;
+    }
+
+    std::vector<uint8_t> received(params.OriginalCount, 0);
+    std::vector<cm65536_block*> original;
+    std::vector<cm65536_block*> recovery;
+
+    for (int ii = 0; ii < params.OriginalCount; ++ii)
+    {
+        const int row = blocks[ii].Index;
+
+        if (row < params.OriginalCount)
+        {
+            // Error out if two row indices repeat
+            if (received[row])
+            {
+                return -5;
+            }
+            received[row] = 1;
+            original.push_back(&blocks[ii]);
+        }
+        else if (row < params.OriginalCount + params.RecoveryCount)
+        {
+            recovery.push_back(&blocks[ii]);
+        }
+        else
+        {
+            return -5;
+        }
+    }
+
+    // If nothing is erased,
+    if (recovery.empty())
+    {
+        return 0;
+    }
+
+    const int N = static_cast<int>(recovery.size());
+    const uint16_t x_0 = static_cast<uint16_t>(params.OriginalCount);
+
+    std::vector<uint16_t> x(N), y(N);
+    for (int ii = 0, jj = 0; ii < params.OriginalCount; ++ii)
+    {
+        if (!received[ii])
+        {
+            y[jj++] = static_cast<uint16_t>(ii);
+        }
+    }
+    for (int ii = 0; ii < N; ++ii)
+    {
+        x[ii] = recovery[ii]->Index;
+    }
+
+    // Eliminate original data from the recovery rows
+    for (int ii = 0; ii < N; ++ii)
+    {
+        for (std::size_t jj = 0; jj < original.size(); ++jj)
+        {
+            m_gf65536Ctx.gf65536_muladd_mem(recovery[ii]->Block, getMatrixElement(x[ii], x_0, original[jj]->Index), original[jj]->Block, params.BlockBytes);
+        }
+    }
+
+    // Closed form inverse of the erased Cauchy submatrix, see above
+    std::vector<uint16_t> P(N, 1), Q(N, 1), R(N, 1), S(N, 1);
+    for (int ii = 0; ii < N; ++ii)
+    {
+        for (int kk = 0; kk < N; ++kk)
+        {
+            P[ii] = m_gf65536Ctx.gf65536_mul(P[ii], gf65536_ctx::gf65536_add(x[ii], y[kk]));
+            Q[ii] = m_gf65536Ctx.gf65536_mul(Q[ii], gf65536_ctx::gf65536_add(x[kk], y[ii]));
+            if (kk != ii)
+            {
+                R[ii] = m_gf65536Ctx.gf65536_mul(R[ii], gf65536_ctx::gf65536_add(x[ii], x[kk]));
+                S[ii] = m_gf65536Ctx.gf65536_mul(S[ii], gf65536_ctx::gf65536_add(y[ii], y[kk]));
+            }
+        }
+    }
+
+    // Solve into scratch space since every output depends on every recovery row
+    std::vector<uint8_t> output(static_cast<std::size_t>(N) * params.BlockBytes);
+
+    for (int ii = 0; ii < N; ++ii)
+    {
+        uint8_t* outBlock = &output[static_cast<std::size_t>(ii) * params.BlockBytes];
+
+        // Fold the column scale 1 / (y_i + x_0) of the matrix into row i of the inverse
+        const uint16_t scale = m_gf65536Ctx.gf65536_div(Q[ii], m_gf65536Ctx.gf65536_mul(S[ii], gf65536_ctx::gf65536_add(y[ii], x_0)));
+
+        for (int jj = 0; jj < N; ++jj)
+        {
+            const uint16_t element = m_gf65536Ctx.gf65536_div(m_gf65536Ctx.gf65536_mul(P[jj], scale), m_gf65536Ctx.gf65536_mul(gf65536_ctx::gf65536_add(x[jj], y[ii]), R[jj]));
+
+            if (jj == 0)
+            {
+                m_gf65536Ctx.gf65536_mul_mem(outBlock, recovery[jj]->Block, element, params.BlockBytes);
+            }
+            else
+            {
+                m_gf65536Ctx.gf65536_muladd_mem(outBlock, element, recovery[jj]->Block, params.BlockBytes);
+            }
+        }
+    }
+
+    for (int ii = 0; ii < N; ++ii)
+    {
+        memcpy(recovery[ii]->Block, &output[static_cast<std::size_t>(ii) * params.BlockBytes], params.BlockBytes);
+        recovery[ii]->Index = y[ii];
+    }
+
+    return 0;
+}
@@ -0,0 +1,211 @@
+/********************************************************
+ * Description : GF(2^16) arithmetic for the wide codec
+ * Author      : yanrk
+ * Email       : yanrkchina@163.com
+ * Version     : 1.0
+ * History     :
+ * Copyright(C): 2025
+ ********************************************************/
+
+#include "gf65536.h"
+
+// x^16 + x^5 + x^3 + x^2 + 1, primitive so the powers of x span the field
+static const unsigned GF65536_POLYNOMIAL = 0x1002D;
+
+gf65536_ctx::gf65536_ctx() :
+    initialized(false)
+{
+    gf65536_init_();
+}
+
+gf65536_ctx::~gf65536_ctx()
+{
+}
+
+int gf65536_ctx::gf65536_init_()
+{
+    // Avoid multiple initialization
+    if (initialized)
+    {
+        return 0;
+    }
+
+    Polynomial = GF65536_POLYNOMIAL;
+
+    uint16_t* exptab = GF65536_EXP_TABLE;
+    uint16_t* logtab = GF65536_LOG_TABLE;
+
+    logtab[0] = 0;
+    exptab[0] = 1;
+    logtab[1] = 0;
+    for (unsigned jj = 1; jj < 65535; ++jj)
+    {
+        unsigned next = (unsigned)exptab[jj - 1] << 1;
+        if (next >= 65536) next ^= Polynomial;
+
+        // A power of x returning to 1 early means the polynomial is not primitive
+        if (next == 1)
+        {
+            return -1;
+        }
+
+        exptab[jj] = static_cast<uint16_t>( next );
+        logtab[next] = static_cast<uint16_t>( jj );
+    }
+
+    for (unsigned jj = 65535; jj < 65535 * 2; ++jj)
+    {
+        exptab[jj] = exptab[jj - 65535];
+    }
+
+    initialized = true;
+    return 0;
+}
+
+/*
+    Bulk multiplication by a constant y
+
+    A 16-bit symbol x is the sum of its four nibbles n_k shifted into place,
+    so x * y = sum over k of (n_k << 4k) * y.  Each partial product is a
+    16-bit value that only depends on the 4-bit n_k, which gives sixteen
+    entry tables that _mm_shuffle_epi8() can look up, one table for the low
+    byte and one for the high byte of the product of each nibble position.
+
+    Eight symbols are processed per 16 bytes: the input is first shuffled so
+    that the low bytes of the symbols sit in lanes 0..7 and the high bytes in
+    lanes 8..15.  Masking the low nibbles then yields n_0 in the low half and
+    n_2 in the high half, shifting yields n_1 and n_3.  The partial products
+    of the high half are moved down before they are added to the low half,
+    and the low and high product bytes are interleaved back into symbols.
+*/
+
+void gf65536_ctx::gf65536_mul_tables(uint16_t y, GF256_M128 * tables)
+{
+    for (int nibble = 0; nibble < 4; ++nibble)
+    {
+        uint8_t lo[16], hi[16];
+
+        for (unsigned x = 0; x < 16; ++x)
+        {
+            const uint16_t product = gf65536_mul(static_cast<uint16_t>( x << (4 * nibble) ), y);
+            lo[x] = static_cast<uint8_t>( product );
+            hi[x] = static_cast<uint8_t>( product >> 8 );
+        }
+
+        tables[nibble * 2] = _mm_set_epi8(
+            lo[15], lo[14], lo[13], lo[12], lo[11], lo[10], lo[9], lo[8],
+            lo[7], lo[6], lo[5], lo[4], lo[3], lo[2], lo[1], lo[0]);
+        tables[nibble * 2 + 1] = _mm_set_epi8(
+            hi[15], hi[14], hi[13], hi[12], hi[11], hi[10], hi[9], hi[8],
+            hi[7], hi[6], hi[5], hi[4], hi[3], hi[2], hi[1], hi[0]);
+    }
+}
+
+static GF256_FORCE_INLINE GF256_M128 gf65536_mul_m128(GF256_M128 x0, const GF256_M128 * tables, GF256_M128 split_mask, GF256_M128 clr_mask)
+{
+    x0 = _mm_shuffle_epi8(x0, split_mask);
+    const GF256_M128 n02 = _mm_and_si128(x0, clr_mask);
+    const GF256_M128 n13 = _mm_and_si128(_mm_srli_epi64(x0, 4), clr_mask);
+
+    GF256_M128 lo = _mm_xor_si128(_mm_shuffle_epi8(tables[0], n02), _mm_shuffle_epi8(tables[2], n13));
+    GF256_M128 hi = _mm_xor_si128(_mm_shuffle_epi8(tables[1], n02), _mm_shuffle_epi8(tables[3], n13));
+    const GF256_M128 lo2 = _mm_xor_si128(_mm_shuffle_epi8(tables[4], n02), _mm_shuffle_epi8(tables[6], n13));
+    const GF256_M128 hi2 = _mm_xor_si128(_mm_shuffle_epi8(tables[5], n02), _mm_shuffle_epi8(tables[7], n13));
+    lo = _mm_xor_si128(lo, _mm_srli_si128(lo2, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(hi2, 8));
+
+    return _mm_unpacklo_epi8(lo, hi);
+}
+
+void gf65536_ctx::gf65536_mul_mem(void * GF256_RESTRICT vz, const void * GF256_RESTRICT vx, uint16_t y, int bytes)
+{
+    // Use a single if-statement to handle special cases
+    if (y <= 1)
+    {
+        if (y == 0)
+        {
+            memset(vz, 0, bytes);
+        }
+        else if (vz != vx)
+        {
+            memcpy(vz, vx, bytes);
+        }
+        return;
+    }
+
+    GF256_ALIGNED GF256_M128 tables[8];
+    gf65536_mul_tables(y, tables);
+
+    // split_mask moves the low bytes of the symbols to lanes 0..7, high bytes to 8..15
+    const GF256_M128 split_mask = _mm_set_epi8(15, 13, 11, 9, 7, 5, 3, 1, 14, 12, 10, 8, 6, 4, 2, 0);
+    const GF256_M128 clr_mask = _mm_set1_epi8(0x0f);
+
+    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128*>(vz);
+    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128*>(vx);
+
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        _mm_storeu_si128(z16, gf65536_mul_m128(_mm_loadu_si128(x16), tables, split_mask, clr_mask));
+
+        x16++;
+        z16++;
+        bytes -= 16;
+    }
+
+    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t*>(z16);
+    const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t*>(x16);
+
+    // Handle final symbols
+    for (; bytes >= 2; bytes -= 2, x1 += 2, z1 += 2)
+    {
+        const uint16_t product = gf65536_mul(static_cast<uint16_t>( x1[0] | (x1[1] << 8) ), y);
+        z1[0] = static_cast<uint8_t>( product );
+        z1[1] = static_cast<uint8_t>( product >> 8 );
+    }
+}
+
+void gf65536_ctx::gf65536_muladd_mem(void * GF256_RESTRICT vz, uint16_t y, const void * GF256_RESTRICT vx, int bytes)
+{
+    // Use a single if-statement to handle special cases
+    if (y <= 1)
+    {
+        if (y == 1)
+        {
+            gf256_ctx::gf256_add_mem(vz, vx, bytes);
+        }
+        return;
+    }
+
+    GF256_ALIGNED GF256_M128 tables[8];
+    gf65536_mul_tables(y, tables);
+
+    // split_mask moves the low bytes of the symbols to lanes 0..7, high bytes to 8..15
+    const GF256_M128 split_mask = _mm_set_epi8(15, 13, 11, 9, 7, 5, 3, 1, 14, 12, 10, 8, 6, 4, 2, 0);
+    const GF256_M128 clr_mask = _mm_set1_epi8(0x0f);
+
+    GF256_M128 * GF256_RESTRICT z16 = reinterpret_cast<GF256_M128*>(vz);
+    const GF256_M128 * GF256_RESTRICT x16 = reinterpret_cast<const GF256_M128*>(vx);
+
+    // Handle multiples of 16 bytes
+    while (bytes >= 16)
+    {
+        const GF256_M128 p0 = gf65536_mul_m128(_mm_loadu_si128(x16), tables, split_mask, clr_mask);
+        _mm_storeu_si128(z16, _mm_xor_si128(p0, _mm_loadu_si128(z16)));
+
+        x16++;
+        z16++;
+        bytes -= 16;
+    }
+
+    uint8_t * GF256_RESTRICT z1 = reinterpret_cast<uint8_t*>(z16);
+    const uint8_t * GF256_RESTRICT x1 = reinterpret_cast<const uint8_t*>(x16);
+
+    // Handle final symbols
+    for (; bytes >= 2; bytes -= 2, x1 += 2, z1 += 2)
+    {
+        const uint16_t product = gf65536_mul(static_cast<uint16_t>( x1[0] | (x1[1] << 8) ), y);
+        z1[0] ^= static_cast<uint8_t>( product );
+        z1[1] ^= static_cast<uint8_t>( product >> 8 );
+    }
+}
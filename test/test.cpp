@@ -8,24 +8,1259 @@
  ********************************************************/
 
 #include <ctime>
+#include <cstdio>
 #include <algorithm>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <thread>
+#ifndef _MSC_VER
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif // _MSC_VER
 #include "cm256_codec.h"
+#include "cm256_window.h"
+#include "cm256_wide.h"
+#include "cm256_multi.h"
+#include "cm256_packer.h"
+#include "cm256_transport.h"
+#include "cm256_pipeline.h"
+#include "cm256_wire.h"
+#include "cm256_crc32c.h"
 
-int main()
+static void create_src_data_list(std::list<std::vector<uint8_t>> & src_data_list)
+{
+    for (std::size_t i = 0; i < 400; ++i)
+    {
+        uint8_t buffer[1600] = { 0x0 };
+        for (std::size_t j = 0; j < sizeof(buffer); ++j)
+        {
+            buffer[j] = static_cast<uint8_t>(rand() % 256);
+        }
+        src_data_list.push_back(std::vector<uint8_t>(buffer, buffer + 1001 + rand() % 600));
+    }
+}
+
+static int test_frame_size()
+{
+    std::list<std::vector<uint8_t>> src_data_list;
+    create_src_data_list(src_data_list);
+
+    std::list<std::vector<uint8_t>> tmp_data_list;
+
+    uint16_t frame_index = 0;
+    uint8_t frame_filter = 0;
+    if (!cm256_encode(frame_index, frame_filter, tmp_data_list, src_data_list, 0.1, 0, true, 20))
+    {
+        return 11;
+    }
+
+    if (20 != frame_index || 440 != tmp_data_list.size())
+    {
+        return 12;
+    }
+
+    std::list<std::vector<uint8_t>> dst_data_list;
+
+    frames_t frames;
+    std::size_t block_index = 0;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = tmp_data_list.begin(); tmp_data_list.end() != iter; ++iter, ++block_index)
+    {
+        if (3 == block_index % 22 || 11 == block_index % 22)
+        {
+            continue;
+        }
+        const std::vector<uint8_t> & data = *iter;
+        if (!cm256_decode(&data[0], data.size(), frames, dst_data_list, 1000 * 15, false))
+        {
+            return 13;
+        }
+    }
+
+    if (src_data_list.size() != dst_data_list.size())
+    {
+        return 14;
+    }
+
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = src_data_list.begin(); src_data_list.end() != iter; ++iter)
+    {
+        if (dst_data_list.end() == std::find(dst_data_list.begin(), dst_data_list.end(), *iter))
+        {
+            return 15;
+        }
+    }
+
+    return 0;
+}
+
+static int test_stream_encode()
+{
+    std::list<std::vector<uint8_t>> src_data_list;
+    create_src_data_list(src_data_list);
+
+    std::list<std::vector<uint8_t>> tmp_data_list;
+
+    stream_encoder_t encoder;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = src_data_list.begin(); src_data_list.end() != iter; ++iter)
+    {
+        const std::size_t tmp_data_size = tmp_data_list.size();
+        if (!cm256_stream_encode(&(*iter)[0], iter->size(), encoder, tmp_data_list, 0.1, 1600, 30, 1000 * 1000, true))
+        {
+            return 21;
+        }
+        if (tmp_data_list.size() == tmp_data_size)
+        {
+            return 22;
+        }
+    }
+
+    if (!cm256_stream_flush(encoder, tmp_data_list))
+    {
+        return 23;
+    }
+
+    /* 13 full frames of 30 + 3 recovery, then a flushed frame of 10 + 1 recovery */
+    if (14 != encoder.frame_index || 13 * 33 + 11 != tmp_data_list.size())
+    {
+        return 24;
+    }
+
+    std::list<std::vector<uint8_t>> dst_data_list;
+
+    frames_t frames;
+    std::size_t block_index = 0;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = tmp_data_list.begin(); tmp_data_list.end() != iter; ++iter, ++block_index)
+    {
+        if ((block_index < 13 * 33 && 5 == block_index % 33) || 13 * 33 + 7 == block_index)
+        {
+            continue;
+        }
+        const std::vector<uint8_t> & data = *iter;
+        if (!cm256_decode(&data[0], data.size(), frames, dst_data_list, 1000 * 15, false))
+        {
+            return 25;
+        }
+    }
+
+    if (src_data_list != dst_data_list)
+    {
+        std::list<std::vector<uint8_t>> src_sort_list(src_data_list);
+        std::list<std::vector<uint8_t>> dst_sort_list(dst_data_list);
+        src_sort_list.sort();
+        dst_sort_list.sort();
+        if (src_sort_list != dst_sort_list)
+        {
+            return 26;
+        }
+    }
+
+    return 0;
+}
+
+static int test_window_codec()
+{
+    std::list<std::vector<uint8_t>> src_data_list;
+    create_src_data_list(src_data_list);
+
+    std::list<std::vector<uint8_t>> tmp_data_list;
+
+    window_encoder_t encoder;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = src_data_list.begin(); src_data_list.end() != iter; ++iter)
+    {
+        if (!cm256_window_encode(&(*iter)[0], iter->size(), encoder, tmp_data_list, 0.2, 16))
+        {
+            return 31;
+        }
+    }
+
+    if (500 != tmp_data_list.size())
+    {
+        return 32;
+    }
+
+    std::list<std::vector<uint8_t>> dst_data_list;
+
+    window_decoder_t decoder;
+    std::size_t block_index = 0;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = tmp_data_list.begin(); tmp_data_list.end() != iter; ++iter, ++block_index)
+    {
+        if (3 == block_index % 10 || (block_index >= 200 && block_index < 203))
+        {
+            continue;
+        }
+        const std::vector<uint8_t> & data = *iter;
+        if (!cm256_window_decode(&data[0], data.size(), decoder, dst_data_list, 16))
+        {
+            return 33;
+        }
+    }
+
+    std::list<std::vector<uint8_t>> src_sort_list(src_data_list);
+    std::list<std::vector<uint8_t>> dst_sort_list(dst_data_list);
+    src_sort_list.sort();
+    dst_sort_list.sort();
+    if (src_sort_list != dst_sort_list)
+    {
+        return 34;
+    }
+
+    /* every source and repair again, old ones reach back past the expired part of the window */
+    const std::size_t delivered_count = dst_data_list.size();
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = tmp_data_list.begin(); tmp_data_list.end() != iter; ++iter)
+    {
+        const std::vector<uint8_t> & data = *iter;
+        if (!cm256_window_decode(&data[0], data.size(), decoder, dst_data_list, 16))
+        {
+            return 35;
+        }
+    }
+    if (delivered_count != dst_data_list.size())
+    {
+        return 36;
+    }
+
+    return 0;
+}
+
+static int test_wide_codec()
+{
+    std::list<std::vector<uint8_t>> src_data_list;
+    create_src_data_list(src_data_list);
+
+    std::list<std::vector<uint8_t>> tmp_data_list;
+
+    uint16_t frame_index = 0;
+    uint8_t frame_filter = 0;
+    if (!cm256_wide_encode(frame_index, frame_filter, tmp_data_list, src_data_list, 0.25, 0, true, 400))
+    {
+        return 41;
+    }
+
+    /* a single frame of 400 + 133 recovery, well past the 256 blocks of GF(2^8) */
+    if (1 != frame_index || 533 != tmp_data_list.size())
+    {
+        return 42;
+    }
+
+    std::list<std::vector<uint8_t>> dst_data_list;
+
+    wide_frames_t frames;
+    std::size_t block_index = 0;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = tmp_data_list.begin(); tmp_data_list.end() != iter; ++iter, ++block_index)
+    {
+        if ((block_index >= 100 && block_index < 160) || 7 == block_index % 11)
+        {
+            continue;
+        }
+        const std::vector<uint8_t> & data = *iter;
+        if (!cm256_wide_decode(&data[0], data.size(), frames, dst_data_list, 1000 * 15, false))
+        {
+            return 43;
+        }
+    }
+
+    std::list<std::vector<uint8_t>> src_sort_list(src_data_list);
+    std::list<std::vector<uint8_t>> dst_sort_list(dst_data_list);
+    src_sort_list.sort();
+    dst_sort_list.sort();
+    if (src_sort_list != dst_sort_list)
+    {
+        return 44;
+    }
+
+    /* many small frames, each frame's bitmap covers its own blocks and no more */
+    std::list<std::vector<uint8_t>> small_data_list;
+    if (!cm256_wide_encode(frame_index, frame_filter, small_data_list, src_data_list, 0.25, 0, true, 4))
+    {
+        return 45;
+    }
+    wide_frames_t small_frames;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = small_data_list.begin(); small_data_list.end() != iter; ++iter)
+    {
+        cm256_wide_decode(&(*iter)[0], iter->size(), small_frames, dst_data_list, 1000 * 15, false);
+    }
+    if (100 != small_frames.item.size())
+    {
+        return 46;
+    }
+    for (std::map<uint16_t, wide_frame_t>::const_iterator iter = small_frames.item.begin(); small_frames.item.end() != iter; ++iter)
+    {
+        const wide_frame_header_t & frame_header = iter->second.header;
+        if ((static_cast<std::size_t>(frame_header.original_count) + frame_header.recovery_count + 7) / 8 != frame_header.block_bitmap.size())
+        {
+            return 46;
+        }
+    }
+
+    /* the largest payload whose block the decoder still takes, and the next one, which is refused */
+    std::list<std::vector<uint8_t>> large_data_list(1, std::vector<uint8_t>(65522, 0x5a));
+    large_data_list.back()[1000] = 0xa5;
+    std::list<std::vector<uint8_t>> large_tmp_list;
+    if (!cm256_wide_encode(frame_index, frame_filter, large_tmp_list, large_data_list, 0.5, 0, true) || 2 != large_tmp_list.size() || 65534 != large_tmp_list.front().size())
+    {
+        return 47;
+    }
+    wide_frames_t large_frames;
+    std::list<std::vector<uint8_t>> large_dst_list;
+    if (!cm256_wide_decode(&large_tmp_list.back()[0], large_tmp_list.back().size(), large_frames, large_dst_list) || large_data_list != large_dst_list)
+    {
+        return 48;
+    }
+    large_data_list.back().push_back(0x5a);
+    large_tmp_list.clear();
+    if (cm256_wide_encode(frame_index, frame_filter, large_tmp_list, large_data_list, 0.5, 0, true) || cm256_wide_encode(frame_index, frame_filter, large_tmp_list, src_data_list, 0.5, 65523, true))
+    {
+        return 49;
+    }
+
+    return 0;
+}
+
+static int test_decode_stats()
+{
+    std::list<std::vector<uint8_t>> src_data_list;
+    create_src_data_list(src_data_list);
+
+    std::list<std::vector<uint8_t>> tmp_data_list;
+
+    uint16_t frame_index = 0;
+    uint8_t frame_filter = 0;
+    if (!cm256_encode(frame_index, frame_filter, tmp_data_list, src_data_list, 0.1, 0, true))
+    {
+        return 51;
+    }
+
+    /* frames of 230 + 25 and 170 + 19, 10 originals of the first one lost and its first block sent twice */
+    std::list<std::vector<uint8_t>> dst_data_list;
+
+    frames_t frames;
+    std::size_t block_index = 0;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = tmp_data_list.begin(); tmp_data_list.end() != iter; ++iter, ++block_index)
+    {
+        if (block_index >= 10 && block_index < 20)
+        {
+            continue;
+        }
+        const std::vector<uint8_t> & data = *iter;
+        cm256_decode(&data[0], data.size(), frames, dst_data_list, 1000 * 15, false);
+        if (0 == block_index)
+        {
+            cm256_decode(&data[0], data.size(), frames, dst_data_list, 1000 * 15, false);
+        }
+    }
+
+    if (src_data_list.size() != dst_data_list.size())
+    {
+        return 52;
+    }
+
+    decode_stats_t stats;
+    cm256_decode_stats(frames, stats);
+
+    if (435 != stats.blocks_received || 1 != stats.blocks_duplicate || 15 + 19 != stats.blocks_late || 0 != stats.blocks_mismatch)
+    {
+        return 53;
+    }
+
+    if (2 != stats.frames_complete || 0 != stats.frames_expired || 1 != stats.frames_recovered || 0 != stats.frames_failed || 10 != stats.blocks_recovered)
+    {
+        return 54;
+    }
+
+    if (2 != stats.frame_microseconds.count || 1 != stats.decode_nanoseconds.count || 1 != stats.recovered_blocks.count || 1 != stats.recovered_blocks.bucket[4])
+    {
+        return 55;
+    }
+
+    return 0;
+}
+
+static int test_encode_profile()
+{
+    std::list<std::vector<uint8_t>> src_data_list;
+    create_src_data_list(src_data_list);
+
+    std::list<std::vector<uint8_t>> tmp_data_list;
+
+    uint16_t frame_index = 0;
+    uint8_t frame_filter = 0;
+    if (!cm256_encode(frame_index, frame_filter, tmp_data_list, src_data_list, 0.1, 0, true))
+    {
+        return 61;
+    }
+
+    /* without CM256_CODEC_PROFILE the probes are compiled out and the profile stays empty */
+    encode_profile_t profile;
+    if (cm256_encode_profile(profile))
+    {
+        if (profile.original_nanoseconds.count < 2 || profile.cm256_nanoseconds.count < 2 || profile.original_bytes < 400 * 1001)
+        {
+            return 62;
+        }
+    }
+    else if (0 != profile.original_bytes || 0 != profile.original_nanoseconds.count || 0 != profile.cm256_nanoseconds.count)
+    {
+        return 63;
+    }
+
+    return 0;
+}
+
+static int test_decoder_session()
+{
+    std::list<std::vector<uint8_t>> src_data_list;
+    create_src_data_list(src_data_list);
+
+    std::list<std::vector<uint8_t>> tmp_data_list;
+
+    uint16_t frame_index = 0;
+    uint8_t frame_filter = 0;
+    if (!cm256_encode(frame_index, frame_filter, tmp_data_list, src_data_list, 0.1, 1600, true, 20))
+    {
+        return 71;
+    }
+
+    /* frames of 20 + 2, only the first block of each frame is sent, so at most 2 wait at a time */
+    cm256_decoder_t * decoder = cm256_decoder_create(1000 * 1000, 2, 1024 * 1024);
+    if (nullptr == decoder)
+    {
+        return 72;
+    }
+
+    std::list<std::vector<uint8_t>> dst_data_list;
+
+    std::size_t block_index = 0;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = tmp_data_list.begin(); tmp_data_list.end() != iter; ++iter, ++block_index)
+    {
+        if (0 == block_index % 22)
+        {
+            cm256_decoder_decode(decoder, &(*iter)[0], iter->size(), dst_data_list);
+        }
+    }
+
+    decode_stats_t stats;
+    if (!cm256_decoder_stats(decoder, stats) || 18 != stats.frames_evicted || 18 != dst_data_list.size())
+    {
+        cm256_decoder_destroy(decoder);
+        return 73;
+    }
+
+    cm256_decoder_destroy(decoder);
+
+    /* room for 5 blocks: the first frame is evicted at its 6th block, the rest of it arrives late */
+    decoder = cm256_decoder_create(1000 * 1000, 64, 5 * tmp_data_list.front().size());
+    if (nullptr == decoder)
+    {
+        return 74;
+    }
+
+    dst_data_list.clear();
+
+    block_index = 0;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = tmp_data_list.begin(); tmp_data_list.end() != iter && block_index < 22; ++iter, ++block_index)
+    {
+        if (3 != block_index)
+        {
+            cm256_decoder_decode(decoder, &(*iter)[0], iter->size(), dst_data_list);
+        }
+    }
+
+    if (!cm256_decoder_stats(decoder, stats) || 1 != stats.frames_evicted || 6 != dst_data_list.size() || 15 != stats.blocks_late)
+    {
+        cm256_decoder_destroy(decoder);
+        return 75;
+    }
+
+    cm256_decoder_destroy(decoder);
+
+    return 0;
+}
+
+static int test_parallel_decoder()
+{
+    std::list<std::vector<uint8_t>> src_data_list;
+    create_src_data_list(src_data_list);
+
+    std::list<std::vector<uint8_t>> tmp_data_list;
+
+    uint16_t frame_index = 0;
+    uint8_t frame_filter = 0;
+    if (!cm256_encode(frame_index, frame_filter, tmp_data_list, src_data_list, 0.1, 1600, true, 20))
+    {
+        return 91;
+    }
+
+    /* the first block of each frame of 20 + 2 is lost, every frame needs recovery and only 2 may wait for the workers */
+    cm256_parallel_decoder_t * decoder = cm256_parallel_decoder_create(4, 1000 * 1000, 2);
+    if (nullptr == decoder)
+    {
+        return 92;
+    }
+
+    frames_t frames;
+    std::list<std::vector<uint8_t>> dst_data_list;
+    std::list<std::vector<uint8_t>> serial_data_list;
+
+    std::size_t block_index = 0;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = tmp_data_list.begin(); tmp_data_list.end() != iter; ++iter, ++block_index)
+    {
+        if (0 != block_index % 22)
+        {
+            cm256_parallel_decoder_decode(decoder, &(*iter)[0], iter->size(), dst_data_list);
+            cm256_decode(&(*iter)[0], iter->size(), frames, serial_data_list, 1000 * 1000);
+        }
+    }
+    cm256_parallel_decoder_flush(decoder, dst_data_list);
+    cm256_decode(nullptr, 0, frames, serial_data_list, 1000 * 1000, true);
+
+    /* same blocks in the same order as the serial decoder */
+    decode_stats_t stats;
+    if (!cm256_parallel_decoder_stats(decoder, stats) || dst_data_list != serial_data_list || src_data_list.size() != dst_data_list.size() || (tmp_data_list.size() + 21) / 22 != stats.frames_recovered)
+    {
+        cm256_parallel_decoder_destroy(decoder);
+        return 93;
+    }
+
+    cm256_parallel_decoder_destroy(decoder);
+
+    return 0;
+}
+
+static uint64_t s_virtual_microseconds = 0;
+
+static void CM256_CODEC_CDECL get_virtual_time(uint32_t & seconds, uint32_t & microseconds)
+{
+    seconds = static_cast<uint32_t>(1000000 + s_virtual_microseconds / 1000000);
+    microseconds = static_cast<uint32_t>(s_virtual_microseconds % 1000000);
+}
+
+static int test_in_order_decoder()
+{
+    std::list<std::vector<uint8_t>> src_data_list;
+    create_src_data_list(src_data_list);
+
+    std::list<std::vector<uint8_t>> tmp_data_list;
+
+    uint16_t frame_index = 0;
+    uint8_t frame_filter = 0;
+    if (!cm256_encode(frame_index, frame_filter, tmp_data_list, src_data_list, 0.1, 1600, true, 20))
+    {
+        return 101;
+    }
+
+    /* frames of 20 + 2 lose their first block, and the frames after the first arrive swapped in pairs */
+    std::vector<std::list<std::vector<uint8_t>>> frame_list((tmp_data_list.size() + 21) / 22);
+    std::size_t block_index = 0;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = tmp_data_list.begin(); tmp_data_list.end() != iter; ++iter, ++block_index)
+    {
+        if (0 != block_index % 22)
+        {
+            frame_list[block_index / 22].push_back(*iter);
+        }
+    }
+    for (std::size_t index = 1; index + 1 < frame_list.size(); index += 2)
+    {
+        frame_list[index].swap(frame_list[index + 1]);
+    }
+
+    cm256_decoder_t * decoder = cm256_decoder_create(1000 * 1000);
+    if (nullptr == decoder || !cm256_decoder_set_in_order(decoder, true, 64, 1000 * 1000))
+    {
+        cm256_decoder_destroy(decoder);
+        return 102;
+    }
+
+    std::list<std::vector<uint8_t>> dst_data_list;
+    for (std::size_t index = 0; index < frame_list.size(); ++index)
+    {
+        for (std::list<std::vector<uint8_t>>::const_iterator iter = frame_list[index].begin(); frame_list[index].end() != iter; ++iter)
+        {
+            cm256_decoder_decode(decoder, &(*iter)[0], iter->size(), dst_data_list);
+        }
+    }
+    cm256_decoder_flush(decoder, dst_data_list);
+
+    decode_stats_t stats;
+    if (!cm256_decoder_stats(decoder, stats) || dst_data_list != src_data_list || 0 != stats.frames_skipped || 0 != stats.frames_late)
+    {
+        cm256_decoder_destroy(decoder);
+        return 103;
+    }
+
+    cm256_decoder_destroy(decoder);
+
+    /* the 6th frame is lost, it is skipped once 3 frames wait behind it and dropped when it turns up */
+    decoder = cm256_decoder_create(1000 * 1000);
+    if (nullptr == decoder || !cm256_decoder_set_in_order(decoder, true, 2, 1000 * 1000))
+    {
+        cm256_decoder_destroy(decoder);
+        return 104;
+    }
+
+    dst_data_list.clear();
+    block_index = 0;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = tmp_data_list.begin(); tmp_data_list.end() != iter; ++iter, ++block_index)
+    {
+        if (5 != block_index / 22)
+        {
+            cm256_decoder_decode(decoder, &(*iter)[0], iter->size(), dst_data_list);
+        }
+    }
+
+    std::list<std::vector<uint8_t>> lost_data_list;
+    std::list<std::vector<uint8_t>>::iterator lost_begin = src_data_list.begin();
+    std::advance(lost_begin, 5 * 20);
+    std::list<std::vector<uint8_t>>::iterator lost_end = lost_begin;
+    std::advance(lost_end, 20);
+    lost_data_list.splice(lost_data_list.end(), src_data_list, lost_begin, lost_end);
+
+    block_index = 0;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = tmp_data_list.begin(); tmp_data_list.end() != iter; ++iter, ++block_index)
+    {
+        if (5 == block_index / 22)
+        {
+            cm256_decoder_decode(decoder, &(*iter)[0], iter->size(), dst_data_list);
+        }
+    }
+    cm256_decoder_flush(decoder, dst_data_list);
+
+    if (!cm256_decoder_stats(decoder, stats) || dst_data_list != src_data_list || 1 != stats.frames_skipped || 1 != stats.frames_late)
+    {
+        cm256_decoder_destroy(decoder);
+        return 105;
+    }
+
+    cm256_decoder_destroy(decoder);
+
+    /*
+     * default hold on a virtual clock, the first frame loses 3 originals and can only come out at its 100ms
+     * deadline, the frames after it complete first and wait for it past the hold, its other originals lead
+     */
+    src_data_list.splice(lost_end, lost_data_list);
+    s_virtual_microseconds = 0;
+    cm256_set_clock(&get_virtual_time);
+    decoder = cm256_decoder_create(1000 * 5);
+    if (nullptr == decoder || !cm256_decoder_set_in_order(decoder, true))
+    {
+        cm256_set_clock(nullptr);
+        cm256_decoder_destroy(decoder);
+        return 106;
+    }
+
+    dst_data_list.clear();
+    block_index = 0;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = tmp_data_list.begin(); tmp_data_list.end() != iter; ++iter, ++block_index)
+    {
+        if (block_index >= 3)
+        {
+            cm256_decoder_decode(decoder, &(*iter)[0], iter->size(), dst_data_list);
+        }
+    }
+    s_virtual_microseconds = 1000 * 99;
+    cm256_decoder_decode(decoder, nullptr, 0, dst_data_list);
+    if (!dst_data_list.empty())
+    {
+        cm256_set_clock(nullptr);
+        cm256_decoder_destroy(decoder);
+        return 107;
+    }
+    s_virtual_microseconds = 1000 * 101;
+    cm256_decoder_decode(decoder, nullptr, 0, dst_data_list);
+    cm256_set_clock(nullptr);
+
+    src_data_list.erase(src_data_list.begin(), std::next(src_data_list.begin(), 3));
+    if (!cm256_decoder_stats(decoder, stats) || dst_data_list != src_data_list || 0 != stats.frames_skipped || 0 != stats.frames_late)
+    {
+        cm256_decoder_destroy(decoder);
+        return 108;
+    }
+
+    cm256_decoder_destroy(decoder);
+
+    return 0;
+}
+
+static int test_packer()
+{
+    /* small messages around ones too big for a single cm256 block */
+    std::list<std::vector<uint8_t>> src_data_list;
+    for (std::size_t i = 0; i < 60; ++i)
+    {
+        std::vector<uint8_t> message(0 == i % 20 ? 70000 + i : 1 + rand() % 200);
+        for (std::size_t j = 0; j < message.size(); ++j)
+        {
+            message[j] = static_cast<uint8_t>(rand() % 256);
+        }
+        src_data_list.push_back(message);
+    }
+
+    const std::size_t block_bytes = 1200;
+
+    packer_t packer;
+    std::list<std::vector<uint8_t>> block_list;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = src_data_list.begin(); src_data_list.end() != iter; ++iter)
+    {
+        if (!cm256_pack(&(*iter)[0], iter->size(), packer, block_list, block_bytes))
+        {
+            return 111;
+        }
+    }
+    cm256_pack_flush(packer, block_list);
+
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = block_list.begin(); block_list.end() != iter; ++iter)
+    {
+        if (iter->size() > block_bytes || (&(*iter) != &block_list.back() && iter->size() + 3 < block_bytes))
+        {
+            return 112;
+        }
+    }
+
+    /* through the codec with the first block of every frame lost */
+    std::list<std::vector<uint8_t>> tmp_data_list;
+    uint16_t frame_index = 0;
+    uint8_t frame_filter = 0;
+    if (!cm256_encode(frame_index, frame_filter, tmp_data_list, block_list, 0.1, block_bytes, true, 20))
+    {
+        return 113;
+    }
+
+    cm256_decoder_t * decoder = cm256_decoder_create(1000 * 1000);
+    cm256_decoder_set_in_order(decoder, true);
+    std::list<std::vector<uint8_t>> dst_block_list;
+    std::size_t block_index = 0;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = tmp_data_list.begin(); tmp_data_list.end() != iter; ++iter, ++block_index)
+    {
+        if (0 != block_index % 22)
+        {
+            cm256_decoder_decode(decoder, &(*iter)[0], iter->size(), dst_block_list);
+        }
+    }
+    cm256_decoder_flush(decoder, dst_block_list);
+    cm256_decoder_destroy(decoder);
+
+    unpacker_t unpacker;
+    std::list<std::vector<uint8_t>> dst_data_list;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = dst_block_list.begin(); dst_block_list.end() != iter; ++iter)
+    {
+        cm256_unpack(&(*iter)[0], iter->size(), unpacker, dst_data_list);
+    }
+
+    if (dst_data_list != src_data_list || 0 != unpacker.dropped_count)
+    {
+        return 114;
+    }
+
+    /* a block lost for good takes the messages it carried part of with it, here the first one */
+    unpacker = unpacker_t();
+    dst_data_list.clear();
+    block_index = 0;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = block_list.begin(); block_list.end() != iter; ++iter, ++block_index)
+    {
+        if (3 != block_index)
+        {
+            cm256_unpack(&(*iter)[0], iter->size(), unpacker, dst_data_list);
+        }
+    }
+
+    std::list<std::vector<uint8_t>>::const_iterator src_iter = src_data_list.begin();
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = dst_data_list.begin(); dst_data_list.end() != iter; ++iter, ++src_iter)
+    {
+        src_iter = std::find(src_iter, src_data_list.cend(), *iter);
+        if (src_data_list.end() == src_iter)
+        {
+            return 115;
+        }
+    }
+
+    if (dst_data_list.size() + 1 != src_data_list.size() || dst_data_list.front() == src_data_list.front() || 1 != unpacker.dropped_count)
+    {
+        return 116;
+    }
+
+    return 0;
+}
+
+#ifndef _MSC_VER
+
+static int test_transport(bool use_uring)
 {
-    srand(static_cast<uint32_t>(time(0)));
+    /* the io_uring run reports from 126 up, a kernel without io_uring runs it on the socket path */
+    const int code = (use_uring ? 126 : 121);
+
+    /* two udp sockets over loopback, the receiver gives up after a second without data */
+    int rx_sock = socket(AF_INET, SOCK_DGRAM, 0);
+    int tx_sock = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in rx_addr;
+    memset(&rx_addr, 0x0, sizeof(rx_addr));
+    rx_addr.sin_family = AF_INET;
+    rx_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(rx_addr);
+    struct timeval timeout = { 1, 0 };
+    if (rx_sock < 0 || tx_sock < 0 || 0 != bind(rx_sock, reinterpret_cast<struct sockaddr *>(&rx_addr), sizeof(rx_addr)) || 
+        0 != getsockname(rx_sock, reinterpret_cast<struct sockaddr *>(&rx_addr), &addr_len) || 
+        0 != connect(tx_sock, reinterpret_cast<struct sockaddr *>(&rx_addr), sizeof(rx_addr)) || 
+        0 != setsockopt(rx_sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)))
+    {
+        close(rx_sock);
+        close(tx_sock);
+        return code;
+    }
 
     std::list<std::vector<uint8_t>> src_data_list;
-    for (std::size_t i = 0; i < 400; ++i)
+    create_src_data_list(src_data_list);
+
+    std::list<std::vector<uint8_t>> tmp_data_list;
+    uint16_t frame_index = 0;
+    uint8_t frame_filter = 0;
+    cm256_encode(frame_index, frame_filter, tmp_data_list, src_data_list, 0.1, 1600, true, 20);
+
+    cm256_transport_t * sender = cm256_transport_create(tx_sock, 64, 1024 * 64, true, use_uring);
+    cm256_transport_t * receiver = cm256_transport_create(rx_sock, 16, 2048, true, use_uring);
+    cm256_decoder_t * decoder = cm256_decoder_create(1000 * 1000);
+    cm256_decoder_set_in_order(decoder, true);
+
+    /* a frame at a time, less its first block, so the socket buffer never overflows */
+    int ret = 0;
+    std::list<std::vector<uint8_t>> dst_data_list;
+    std::size_t block_index = 0;
+    while (0 == ret && !tmp_data_list.empty())
     {
-        uint8_t buffer[1600] = { 0x0 };
-        for (std::size_t j = 0; j < sizeof(buffer); ++j)
+        std::list<std::vector<uint8_t>> send_data_list;
+        for (std::size_t count = 0; count < 22 && !tmp_data_list.empty(); ++count, ++block_index)
         {
-            buffer[j] = static_cast<uint8_t>(rand() % 256);
+            if (0 != block_index % 22)
+            {
+                send_data_list.push_back(tmp_data_list.front());
+            }
+            tmp_data_list.pop_front();
         }
-        src_data_list.push_back(std::vector<uint8_t>(buffer, buffer + 1001 + rand() % 600));
+
+        if (!cm256_transport_send(sender, send_data_list))
+        {
+            ret = code + 1;
+            break;
+        }
+
+        std::size_t receive_count = 0;
+        while (receive_count < send_data_list.size())
+        {
+            std::list<std::vector<uint8_t>> recv_data_list;
+            if (!cm256_transport_receive(receiver, recv_data_list))
+            {
+                ret = code + 2;
+                break;
+            }
+            receive_count += recv_data_list.size();
+            for (std::list<std::vector<uint8_t>>::const_iterator iter = recv_data_list.begin(); recv_data_list.end() != iter; ++iter)
+            {
+                cm256_decoder_decode(decoder, &(*iter)[0], iter->size(), dst_data_list);
+            }
+        }
+    }
+    cm256_decoder_flush(decoder, dst_data_list);
+
+    if (0 == ret && dst_data_list != src_data_list)
+    {
+        ret = code + 3;
+    }
+
+    /* nothing is left in flight, so the receive timeout has to end the wait */
+    std::list<std::vector<uint8_t>> idle_data_list;
+    if (0 == ret && cm256_transport_receive(receiver, idle_data_list))
+    {
+        ret = code + 4;
+    }
+
+    cm256_decoder_destroy(decoder);
+    cm256_transport_destroy(receiver);
+    cm256_transport_destroy(sender);
+    close(rx_sock);
+    close(tx_sock);
+
+    return ret;
+}
+
+#endif // _MSC_VER
+
+struct multi_output_t
+{
+    std::mutex                                              mutex;
+    std::map<uint64_t, std::list<std::vector<uint8_t>>>     data_map;
+};
+
+static void CM256_CODEC_CDECL deliver_multi_output(void * context, uint64_t stream_id, std::list<std::vector<uint8_t>> & dst_data_list)
+{
+    multi_output_t * output = reinterpret_cast<multi_output_t *>(context);
+    std::lock_guard<std::mutex> lock(output->mutex);
+    std::list<std::vector<uint8_t>> & data_list = output->data_map[stream_id];
+    data_list.splice(data_list.end(), dst_data_list);
+}
+
+static int test_multi_decoder()
+{
+    const std::size_t stream_count = 6;
+    const std::size_t thread_count = 3;
+
+    std::vector<std::list<std::vector<uint8_t>>> src_data_lists(stream_count);
+    std::vector<std::vector<std::vector<uint8_t>>> tmp_data_lists(stream_count);
+    for (std::size_t stream_index = 0; stream_index < stream_count; ++stream_index)
+    {
+        create_src_data_list(src_data_lists[stream_index]);
+
+        std::list<std::vector<uint8_t>> tmp_data_list;
+        uint16_t frame_index = 0;
+        uint8_t frame_filter = 0;
+        if (!cm256_encode(frame_index, frame_filter, tmp_data_list, src_data_lists[stream_index], 0.1, 0, true))
+        {
+            return 81;
+        }
+        tmp_data_lists[stream_index].assign(tmp_data_list.begin(), tmp_data_list.end());
+    }
+
+    multi_output_t output;
+    /* generous deadlines so that a loaded machine does not expire frames the threads are still sending */
+    cm256_multi_decoder_t * decoder = cm256_multi_decoder_create(2, &deliver_multi_output, &output, 1000 * 1000);
+    if (nullptr == decoder)
+    {
+        return 82;
+    }
+
+    /* every thread sends every third block of every stream, one block in 40 is lost */
+    std::vector<std::thread> thread_list;
+    for (std::size_t thread_index = 0; thread_index < thread_count; ++thread_index)
+    {
+        thread_list.push_back(std::thread([&, thread_index]()
+        {
+            for (std::size_t block_index = thread_index; block_index < tmp_data_lists[0].size(); block_index += thread_count)
+            {
+                for (std::size_t stream_index = 0; stream_index < stream_count; ++stream_index)
+                {
+                    const std::vector<uint8_t> & data = tmp_data_lists[stream_index][block_index];
+                    if (7 != (block_index + stream_index) % 40)
+                    {
+                        cm256_multi_decoder_push(decoder, 1000 + stream_index, &data[0], data.size());
+                    }
+                }
+            }
+        }));
+    }
+    for (std::size_t thread_index = 0; thread_index < thread_count; ++thread_index)
+    {
+        thread_list[thread_index].join();
+    }
+
+    for (std::size_t stream_index = 0; stream_index < stream_count; ++stream_index)
+    {
+        cm256_multi_decoder_close(decoder, 1000 + stream_index);
+    }
+
+    cm256_multi_decoder_destroy(decoder);
+
+    for (std::size_t stream_index = 0; stream_index < stream_count; ++stream_index)
+    {
+        std::list<std::vector<uint8_t>> src_sort_list(src_data_lists[stream_index]);
+        std::list<std::vector<uint8_t>> dst_sort_list(output.data_map[1000 + stream_index]);
+        src_sort_list.sort();
+        dst_sort_list.sort();
+        if (src_sort_list != dst_sort_list)
+        {
+            return 83;
+        }
+    }
+
+    return 0;
+}
+
+static void CM256_CODEC_CDECL send_pipeline_output(void * context, const std::list<std::vector<uint8_t>> & data_list)
+{
+    std::list<std::vector<uint8_t>> * output_list = reinterpret_cast<std::list<std::vector<uint8_t>> *>(context);
+    output_list->insert(output_list->end(), data_list.begin(), data_list.end());
+}
+
+static int test_pipeline()
+{
+    std::list<std::vector<uint8_t>> src_data_list;
+    create_src_data_list(src_data_list);
+
+    /* the same blocks the streaming encoder gives in the caller, deadlines far enough not to close a frame */
+    std::list<std::vector<uint8_t>> tmp_data_list;
+    stream_encoder_t encoder;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = src_data_list.begin(); src_data_list.end() != iter; ++iter)
+    {
+        cm256_stream_encode(&(*iter)[0], iter->size(), encoder, tmp_data_list, 0.1, 1600, 30, 1000 * 1000 * 10, true);
+    }
+    cm256_stream_flush(encoder, tmp_data_list);
+
+    /* small rings, so both stages have to wait for the next one */
+    std::list<std::vector<uint8_t>> output_list;
+    cm256_pipeline_t * pipeline = cm256_pipeline_create(&send_pipeline_output, &output_list, 0.1, 1600, 30, 1000 * 1000 * 10, true, 8, 5);
+    if (nullptr == pipeline)
+    {
+        return 131;
+    }
+
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = src_data_list.begin(); src_data_list.end() != iter; ++iter)
+    {
+        if (!cm256_pipeline_push(pipeline, &(*iter)[0], iter->size()))
+        {
+            cm256_pipeline_destroy(pipeline);
+            return 132;
+        }
+    }
+    cm256_pipeline_flush(pipeline);
+
+    /* flush hands everything to send before it returns */
+    const bool same = (output_list == tmp_data_list);
+    cm256_pipeline_destroy(pipeline);
+
+    if (!same)
+    {
+        return 133;
+    }
+
+    return 0;
+}
+
+static int test_wire_format()
+{
+    std::list<std::vector<uint8_t>> src_data_list;
+    create_src_data_list(src_data_list);
+
+    std::list<std::vector<uint8_t>> tmp_data_list;
+    uint16_t frame_index = 0;
+    uint8_t frame_filter = 0;
+    cm256_encode(frame_index, frame_filter, tmp_data_list, src_data_list, 0.1, 1600, true, 30);
+
+    /* the stream's full frames, as the two ends would have agreed */
+    wire_format_t format;
+    format.version = 2;
+    format.block_bytes = 1600;
+    format.original_count = tmp_data_list.front()[4];
+    format.recovery_count = tmp_data_list.front()[5];
+
+    std::list<std::vector<uint8_t>> wire_data_list(tmp_data_list);
+    if (!cm256_wire_pack(format, wire_data_list) || wire_data_list.size() != tmp_data_list.size())
+    {
+        return 141;
+    }
+
+    std::size_t tmp_bytes = 0;
+    std::size_t wire_bytes = 0;
+    std::list<std::vector<uint8_t>>::const_iterator tmp_iter = tmp_data_list.begin();
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = wire_data_list.begin(); wire_data_list.end() != iter; ++iter, ++tmp_iter)
+    {
+        std::vector<uint8_t> block;
+        if (!cm256_wire_unpack(format, &(*iter)[0], iter->size(), block) || block != *tmp_iter)
+        {
+            return 142;
+        }
+        tmp_bytes += tmp_iter->size();
+        wire_bytes += iter->size();
+    }
+
+    /* originals lose their padding and three of their eight header bytes */
+    if (wire_bytes >= tmp_bytes)
+    {
+        return 143;
+    }
+
+    /* a peer on version 2 next to one on version 1, one block in 25 lost on each */
+    cm256_decoder_t * decoders[2] = { cm256_decoder_create(1000 * 1000), cm256_decoder_create(1000 * 1000) };
+    cm256_decoder_set_wire_format(decoders[1], format);
+    const std::list<std::vector<uint8_t>> * data_lists[2] = { &tmp_data_list, &wire_data_list };
+
+    int ret = 0;
+    for (std::size_t peer_index = 0; peer_index < 2 && 0 == ret; ++peer_index)
+    {
+        std::list<std::vector<uint8_t>> dst_data_list;
+        std::size_t block_index = 0;
+        for (std::list<std::vector<uint8_t>>::const_iterator iter = data_lists[peer_index]->begin(); data_lists[peer_index]->end() != iter; ++iter, ++block_index)
+        {
+            if (3 != block_index % 25)
+            {
+                cm256_decoder_decode(decoders[peer_index], &(*iter)[0], iter->size(), dst_data_list);
+            }
+        }
+        cm256_decoder_flush(decoders[peer_index], dst_data_list);
+
+        dst_data_list.sort();
+        std::list<std::vector<uint8_t>> src_sort_list(src_data_list);
+        src_sort_list.sort();
+        if (src_sort_list != dst_data_list)
+        {
+            ret = 144;
+        }
+    }
+
+    cm256_decoder_destroy(decoders[0]);
+    cm256_decoder_destroy(decoders[1]);
+
+    return ret;
+}
+
+/* one bit at a time, the reference the table and sse4.2 paths are held to */
+static uint32_t crc32c_bitwise(const uint8_t * data, std::size_t data_len, uint32_t crc)
+{
+    crc = ~crc;
+    for (std::size_t index = 0; index < data_len; ++index)
+    {
+        crc ^= data[index];
+        for (std::size_t bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc >> 1) ^ (0x82F63B78 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static int test_block_checksum()
+{
+    /* the check value of the castagnoli crc */
+    if (0xE3069283 != cm256_crc32c("123456789", 9) || cm256_crc32c("123456789", 9) != cm256_crc32c("6789", 4, cm256_crc32c("12345", 5)))
+    {
+        return 151;
+    }
+
+    /* every length up to past three times the 3 x 128 byte stride of the sse4.2 path, at every misalignment, whole and split */
+    std::vector<uint8_t> buffer(1200 + 8);
+    for (std::size_t index = 0; index < buffer.size(); ++index)
+    {
+        buffer[index] = static_cast<uint8_t>(rand() % 256);
+    }
+    for (std::size_t offset = 0; offset < 8; ++offset)
+    {
+        for (std::size_t length = 0; length <= 1200; ++length)
+        {
+            const uint8_t * data = &buffer[offset];
+            const uint32_t crc = crc32c_bitwise(data, length, 0);
+            const std::size_t split = length / 3 + offset;
+            if (crc != cm256_crc32c(data, length) || (split <= length && crc != cm256_crc32c(data + split, length - split, cm256_crc32c(data, split))))
+            {
+                return 152;
+            }
+        }
+    }
+
+    std::list<std::vector<uint8_t>> src_data_list;
+    create_src_data_list(src_data_list);
+
+    std::list<std::vector<uint8_t>> tmp_data_list;
+    uint16_t frame_index = 0;
+    uint8_t frame_filter = 0;
+    cm256_encode(frame_index, frame_filter, tmp_data_list, src_data_list, 0.1, 1600, true, 20);
+
+    wire_format_t format;
+    format.checksum = true;
+    if (!cm256_wire_pack(format, tmp_data_list))
+    {
+        return 153;
+    }
+
+    /* one bit flipped in a block of every frame, in its header, its payload or its trailer */
+    cm256_decoder_t * decoder = cm256_decoder_create(1000 * 1000);
+    cm256_decoder_set_wire_format(decoder, format);
+
+    std::list<std::vector<uint8_t>> dst_data_list;
+    std::size_t block_index = 0;
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = tmp_data_list.begin(); tmp_data_list.end() != iter; ++iter, ++block_index)
+    {
+        std::vector<uint8_t> data(*iter);
+        if (5 == block_index % 22)
+        {
+            const std::size_t offsets[3] = { 4, data.size() / 2, data.size() - 1 };
+            data[offsets[block_index / 22 % 3]] ^= 0x10;
+        }
+        cm256_decoder_decode(decoder, &data[0], data.size(), dst_data_list);
+    }
+    cm256_decoder_flush(decoder, dst_data_list);
+
+    decode_stats_t stats;
+    cm256_decoder_stats(decoder, stats);
+    cm256_decoder_destroy(decoder);
+
+    if (20 != stats.blocks_corrupt || 0 != stats.frames_failed)
+    {
+        return 154;
+    }
+
+    dst_data_list.sort();
+    src_data_list.sort();
+    if (src_data_list != dst_data_list)
+    {
+        return 155;
+    }
+
+    return 0;
+}
+
+static int test_malformed_blocks()
+{
+    std::list<std::vector<uint8_t>> src_data_list;
+    create_src_data_list(src_data_list);
+
+    std::list<std::vector<uint8_t>> tmp_data_list;
+    uint16_t frame_index = 0;
+    uint8_t frame_filter = 0;
+    cm256_encode(frame_index, frame_filter, tmp_data_list, src_data_list, 0.1, 1600, true, 20);
+
+    /* truncated, an empty frame, an index past the frame, a length past the datagram, an oversized frame */
+    const std::vector<uint8_t> & block = tmp_data_list.front();
+    std::vector<std::vector<uint8_t>> bad_data_list(5, block);
+    bad_data_list[0].resize(7);
+    bad_data_list[1][4] = 0;
+    bad_data_list[2][3] = static_cast<uint8_t>(block[4] + block[5]);
+    bad_data_list[3][6] = 0xFF;
+    bad_data_list[4][5] = static_cast<uint8_t>(256 - block[4]);
+
+    cm256_decoder_t * decoder = cm256_decoder_create(1000 * 1000);
+    frames_t frames;
+    std::list<std::vector<uint8_t>> dst_data_list;
+    for (std::size_t index = 0; index < bad_data_list.size(); ++index)
+    {
+        const std::vector<uint8_t> & data = bad_data_list[index];
+        if (cm256_decoder_decode(decoder, &data[0], data.size(), dst_data_list) || cm256_decode(&data[0], data.size(), frames, dst_data_list))
+        {
+            cm256_decoder_destroy(decoder);
+            return 161;
+        }
+    }
+
+    decode_stats_t stats;
+    cm256_decoder_stats(decoder, stats);
+    decode_stats_t frames_stats;
+    cm256_decode_stats(frames, frames_stats);
+    if (5 != stats.blocks_malformed || 5 != frames_stats.blocks_malformed || !frames.item.empty() || !dst_data_list.empty())
+    {
+        cm256_decoder_destroy(decoder);
+        return 162;
+    }
+
+    /* the session is untouched, the real stream still decodes */
+    for (std::list<std::vector<uint8_t>>::const_iterator iter = tmp_data_list.begin(); tmp_data_list.end() != iter; ++iter)
+    {
+        cm256_decoder_decode(decoder, &(*iter)[0], iter->size(), dst_data_list);
+    }
+    cm256_decoder_flush(decoder, dst_data_list);
+    cm256_decoder_destroy(decoder);
+
+    if (src_data_list != dst_data_list)
+    {
+        return 163;
     }
 
+    return 0;
+}
+
+int main()
+{
+    srand(static_cast<uint32_t>(time(0)));
+
+    std::list<std::vector<uint8_t>> src_data_list;
+    create_src_data_list(src_data_list);
+
     std::list<std::vector<uint8_t>> tmp_data_list;
 
     uint16_t frame_index = 0;
@@ -86,6 +1321,110 @@ int main()
         }
     }
 
+    int ret = test_frame_size();
+    if (0 != ret)
+    {
+        return ret;
+    }
+
+    ret = test_stream_encode();
+    if (0 != ret)
+    {
+        return ret;
+    }
+
+    ret = test_window_codec();
+    if (0 != ret)
+    {
+        return ret;
+    }
+
+    ret = test_wide_codec();
+    if (0 != ret)
+    {
+        return ret;
+    }
+
+    ret = test_decode_stats();
+    if (0 != ret)
+    {
+        return ret;
+    }
+
+    ret = test_encode_profile();
+    if (0 != ret)
+    {
+        return ret;
+    }
+
+    ret = test_decoder_session();
+    if (0 != ret)
+    {
+        return ret;
+    }
+
+    ret = test_multi_decoder();
+    if (0 != ret)
+    {
+        return ret;
+    }
+
+    ret = test_parallel_decoder();
+    if (0 != ret)
+    {
+        return ret;
+    }
+
+    ret = test_in_order_decoder();
+    if (0 != ret)
+    {
+        return ret;
+    }
+
+    ret = test_packer();
+    if (0 != ret)
+    {
+        return ret;
+    }
+
+#ifndef _MSC_VER
+    ret = test_transport(false);
+    if (0 != ret)
+    {
+        return ret;
+    }
+
+    ret = test_transport(true);
+    if (0 != ret)
+    {
+        return ret;
+    }
+#endif // _MSC_VER
+
+    ret = test_pipeline();
+    if (0 != ret)
+    {
+        return ret;
+    }
+
+    ret = test_wire_format();
+    if (0 != ret)
+    {
+        return ret;
+    }
+
+    ret = test_block_checksum();
+    if (0 != ret)
+    {
+        return ret;
+    }
+
+    ret = test_malformed_blocks();
+    if (0 != ret)
+    {
+        return ret;
+    }
+
     if (dst_data_list == src_data_list)
     {
         printf("ok 1\n");
@@ -0,0 +1,368 @@
+/*
+    Copyright (c) 2015 Christopher A. Taylor.  All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice,
+      this list of conditions and the following disclaimer in the documentation
+      and/or other materials provided with the distribution.
+    * Neither the name of CM256 nor the names of its contributors may be
+      used to endorse or promote products derived from this software without
+      specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+    AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+    IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+    ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+    LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+    CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+    CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * usage: gf256_tables_gen [check] [output.cpp]
+ * computes the gf256_ctx tables the way gf256_ctx used to at run time and writes them out as
+ * the static const definitions of src/gf256_tables.cpp (stdout by default), check compares
+ * the named file against what would be written and fails when it is out of date
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <stdint.h>
+
+// 0xa6, the 4th of the 16 irreducible polynomials for GF(256), as gf256_ctx::Polynomial
+static const unsigned Polynomial = (0xa6 << 1) | 1;
+
+static uint16_t GF256_LOG_TABLE[256];
+static uint8_t GF256_EXP_TABLE[512 * 2 + 1];
+static uint8_t GF256_MUL_TABLE[256 * 256];
+static uint8_t GF256_DIV_TABLE[256 * 256];
+static uint8_t GF256_INV_TABLE[256];
+static uint8_t MM256_TABLE_LO_Y[256][16];
+static uint8_t MM256_TABLE_HI_Y[256][16];
+
+//-----------------------------------------------------------------------------
+// Exponential and Log Tables
+
+// Construct EXP and LOG tables from polynomial
+static void gf256_explog_init()
+{
+    unsigned poly = Polynomial;
+    uint8_t* exptab = GF256_EXP_TABLE;
+    uint16_t* logtab = GF256_LOG_TABLE;
+
+    logtab[0] = 512;
+    exptab[0] = 1;
+    for (unsigned jj = 1; jj < 255; ++jj)
+    {
+        unsigned next = (unsigned)exptab[jj - 1] * 2;
+        if (next >= 256) next ^= poly;
+
+        exptab[jj] = static_cast<uint8_t>( next );
+        logtab[exptab[jj]] = static_cast<uint16_t>( jj );
+    }
+
+    exptab[255] = exptab[0];
+    logtab[exptab[255]] = 255;
+
+    for (unsigned jj = 256; jj < 2 * 255; ++jj)
+    {
+        exptab[jj] = exptab[jj % 255];
+    }
+
+    exptab[2 * 255] = 1;
+
+    for (unsigned jj = 2 * 255 + 1; jj < 4 * 255; ++jj)
+    {
+        exptab[jj] = 0;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Multiply and Divide Tables
+
+// Initialize MUL and DIV tables using LOG and EXP tables
+static void gf256_muldiv_init()
+{
+    // Allocate table memory 65KB x 2
+    uint8_t* m = GF256_MUL_TABLE;
+    uint8_t* d = GF256_DIV_TABLE;
+
+    // Unroll y = 0 subtable
+    for (int x = 0; x < 256; ++x)
+    {
+        m[x] = d[x] = 0;
+    }
+
+    // For each other y value,
+    for (int y = 1; y < 256; ++y)
+    {
+        // Calculate log(y) for mult and 255 - log(y) for div
+        const uint8_t log_y = static_cast<uint8_t>(GF256_LOG_TABLE[y]);
+        const uint8_t log_yn = 255 - log_y;
+
+        // Next subtable
+        m += 256;
+        d += 256;
+
+        // Unroll x = 0
+        m[0] = 0;
+        d[0] = 0;
+
+        // Calculate x * y, x / y
+        for (int x = 1; x < 256; ++x)
+        {
+            uint16_t log_x = GF256_LOG_TABLE[x];
+
+            m[x] = GF256_EXP_TABLE[log_x + log_y];
+            d[x] = GF256_EXP_TABLE[log_x + log_yn];
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Inverse Table
+
+// Initialize INV table using DIV table
+static void gf256_inv_init()
+{
+    for (int x = 0; x < 256; ++x)
+    {
+        GF256_INV_TABLE[x] = GF256_DIV_TABLE[(static_cast<unsigned>(x) << 8) + 1];
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Multiply and Add Memory Tables
+
+/*
+    Fast algorithm to compute m[1..8] = a[1..8] * b in GF(256)
+    using SSE3 SIMD instruction set:
+
+    Consider z = x * y in GF(256).
+    This operation can be performed bit-by-bit.  Usefully, the partial product
+    of each bit is combined linearly with the rest.  This means that the 8-bit
+    number x can be split into its high and low 4 bits, and partial products
+    can be formed from each half.  Then the halves can be linearly combined:
+
+        z = x[0..3] * y + x[4..7] * y
+
+    The multiplication of each half can be done efficiently via table lookups,
+    and the addition in GF(256) is XOR.  There must be two tables that map 16
+    input elements for the low or high 4 bits of x to the two partial products.
+    Each value for y has a different set of two tables:
+
+        z = TABLE_LO_y(x[0..3]) xor TABLE_HI_y(x[4..7])
+
+    This means that we need 16 * 2 * 256 = 8192 bytes for precomputed tables.
+
+    Computing z[] = x[] * y can be performed 16 bytes at a time by using the
+    128-bit register operations supported by modern processors.
+
+    This is efficiently realized in SSE3 using the _mm_shuffle_epi8() function
+    provided by Visual Studio 2010 or newer in <tmmintrin.h>.  This function
+    uses the low bits to do a table lookup on each byte.  Unfortunately the
+    high bit of each mask byte has the special feature that it clears the
+    output byte when it is set, so we need to make sure it's cleared by masking
+    off the high bit of each byte before using it:
+
+        clr_mask = _mm_set1_epi8(0x0f) = 0x0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f0f
+
+    For the low half of the partial product, clear the high bit of each byte
+    and perform the table lookup:
+
+        p_lo = _mm_and_si128(x, clr_mask)
+        p_lo = _mm_shuffle_epi8(p_lo, TABLE_LO_y)
+
+    For the high half of the partial product, shift the high 4 bits of each
+    byte into the low 4 bits and clear the high bit of each byte, and then
+    perform the table lookup:
+
+        p_hi = _mm_srli_epi64(x, 4)
+        p_hi = _mm_and_si128(p_hi, clr_mask)
+        p_hi = _mm_shuffle_epi8(p_hi, TABLE_HI_y)
+
+    Finally add the two partial products to form the product, recalling that
+    addition is XOR in a Galois field:
+
+        result = _mm_xor_si128(p_lo, p_hi)
+
+    This crunches 16 bytes of x at a time, and the result can be stored in z.
+*/
+
+/*
+    Intrinsic reference:
+
+    SSE3, VS2010+, tmmintrin.h:
+
+    GF256_M128 _mm_shuffle_epi8(GF256_M128 a, GF256_M128 mask);
+        Emits the Supplemental Streaming SIMD Extensions 3 (SSSE3) instruction pshufb. This instruction shuffles 16-byte parameters from a 128-bit parameter.
+
+        Pseudo-code for PSHUFB (with 128 bit operands):
+
+            for i = 0 to 15 {
+                 if (SRC[(i * 8)+7] = 1 ) then
+                      DEST[(i*8)+7..(i*8)+0] <- 0;
+                  else
+                      index[3..0] <- SRC[(i*8)+3 .. (i*8)+0];
+                      DEST[(i*8)+7..(i*8)+0] <- DEST[(index*8+7)..(index*8+0)];
+                 endif
+            }
+
+    SSE2, VS2008+, emmintrin.h:
+
+    GF256_M128 _mm_slli_epi64 (GF256_M128 a, int count);
+        Shifts the 2 signed or unsigned 64-bit integers in a left by count bits while shifting in zeros.
+    GF256_M128 _mm_srli_epi64 (GF256_M128 a, int count);
+        Shifts the 2 signed or unsigned 64-bit integers in a right by count bits while shifting in zeros.
+    GF256_M128 _mm_set1_epi8 (char b);
+        Sets the 16 signed 8-bit integer values to b.
+    GF256_M128 _mm_and_si128 (GF256_M128 a, GF256_M128 b);
+        Computes the bitwise AND of the 128-bit value in a and the 128-bit value in b.
+    GF256_M128 _mm_xor_si128 ( GF256_M128 a, GF256_M128 b);
+        Computes the bitwise XOR of the 128-bit value in a and the 128-bit value in b.
+*/
+
+// Initialize the MM256 tables using the MUL table
+static void gf256_muladd_mem_init()
+{
+    for (int y = 0; y < 256; ++y)
+    {
+        // TABLE_LO_Y maps 0..15 to 8-bit partial product based on y.
+        for (unsigned x = 0; x < 16; ++x)
+        {
+            MM256_TABLE_LO_Y[y][x] = GF256_MUL_TABLE[(static_cast<unsigned>(y) << 8) + x];
+            MM256_TABLE_HI_Y[y][x] = GF256_MUL_TABLE[(static_cast<unsigned>(y) << 8) + (x << 4)];
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Output
+
+template <typename T>
+static void append_values(std::string & text, const T * values, int count, const char * indent, const char * format)
+{
+    char buffer[16] = { 0x0 };
+    for (int index = 0; index < count; ++index)
+    {
+        if (0 == index % 16)
+        {
+            text += indent;
+        }
+        snprintf(buffer, sizeof(buffer), format, static_cast<unsigned>(values[index]));
+        text += buffer;
+        text += (count - 1 == index ? "\n" : (15 == index % 16 ? ",\n" : ", "));
+    }
+}
+
+template <typename T>
+static void append_table(std::string & text, const char * definition, const T * values, int count, const char * format)
+{
+    text += definition;
+    text += " = {\n";
+    append_values(text, values, count, "    ", format);
+    text += "};\n\n";
+}
+
+static void append_mm256_table(std::string & text, const char * definition, const uint8_t (*values)[16])
+{
+    text += definition;
+    text += " = {\n";
+    for (int y = 0; y < 256; ++y)
+    {
+        text += "    {\n";
+        append_values(text, values[y], 16, "        ", "0x%02x");
+        text += (255 == y ? "    }\n" : "    },\n");
+    }
+    text += "};\n\n";
+}
+
+static std::string generate()
+{
+    gf256_explog_init();
+    gf256_muldiv_init();
+    gf256_inv_init();
+    gf256_muladd_mem_init();
+
+    std::string text;
+    text += "/*\n";
+    text += " * GF(256) tables of gf256_ctx over the polynomial 0x14d, generated by tools/gf256_tables_gen.cpp,\n";
+    text += " * do not edit: build the gf256_tables target to write it again\n";
+    text += " */\n\n";
+    text += "#include \"gf256.h\"\n\n";
+    append_table(text, "const uint16_t gf256_ctx::GF256_LOG_TABLE[256]", GF256_LOG_TABLE, 256, "%u");
+    append_table(text, "const uint8_t gf256_ctx::GF256_EXP_TABLE[512 * 2 + 1]", GF256_EXP_TABLE, 512 * 2 + 1, "0x%02x");
+    append_table(text, "const uint8_t gf256_ctx::GF256_MUL_TABLE[256 * 256]", GF256_MUL_TABLE, 256 * 256, "0x%02x");
+    append_table(text, "const uint8_t gf256_ctx::GF256_DIV_TABLE[256 * 256]", GF256_DIV_TABLE, 256 * 256, "0x%02x");
+    append_table(text, "const uint8_t gf256_ctx::GF256_INV_TABLE[256]", GF256_INV_TABLE, 256, "0x%02x");
+    append_mm256_table(text, "GF256_ALIGNED const uint8_t gf256_ctx::MM256_TABLE_LO_Y[256][16]", MM256_TABLE_LO_Y);
+    append_mm256_table(text, "GF256_ALIGNED const uint8_t gf256_ctx::MM256_TABLE_HI_Y[256][16]", MM256_TABLE_HI_Y);
+    text.erase(text.size() - 1);
+    return text;
+}
+
+static bool read_file(const char * path, std::string & text)
+{
+    FILE * file = fopen(path, "rb");
+    if (nullptr == file)
+    {
+        return false;
+    }
+
+    char buffer[4096];
+    std::size_t bytes = 0;
+    while (0 != (bytes = fread(buffer, 1, sizeof(buffer), file)))
+    {
+        text.append(buffer, bytes);
+    }
+
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char * argv[])
+{
+    const std::string text = generate();
+
+    if (argc >= 2 && 0 == strcmp(argv[1], "check"))
+    {
+        std::string current;
+        if (3 != argc || !read_file(argv[2], current))
+        {
+            fprintf(stderr, "usage: %s check file.cpp\n", argv[0]);
+            return 1;
+        }
+        if (current != text)
+        {
+            fprintf(stderr, "%s is out of date, build the gf256_tables target\n", argv[2]);
+            return 1;
+        }
+        return 0;
+    }
+
+    FILE * file = (argc >= 2 ? fopen(argv[1], "wb") : stdout);
+    if (nullptr == file)
+    {
+        fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+    fwrite(text.data(), 1, text.size(), file);
+    if (stdout != file)
+    {
+        fclose(file);
+    }
+
+    return 0;
+}